@@ -0,0 +1,117 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#include "AssumptionSet.h"
+
+using namespace upmax;
+
+void AssumptionSet::clear() {
+  for (int i = 0; i < _base.size(); i++)
+    _state[var(_base[i])] = _ABSENT_;
+  _base.clear();
+  _tail.clear();
+  _lits.clear();
+  _nRemoved = 0;
+  _dirty = false;
+}
+
+void AssumptionSet::add(Lit p) {
+  _state.growTo(var(p) + 1, _ABSENT_);
+  _index.growTo(var(p) + 1, -1);
+
+  if (has(p))
+    return;
+  remove(~p);
+
+  if (_state[var(p)] == _REMOVED_ && _base[_index[var(p)]] == p) {
+    // Still in '_base': it keeps its previous position.
+    assert(_nRemoved > 0);
+    _nRemoved--;
+  } else {
+    // A removed literal of the opposite sign stays pending removal.
+    _index[var(p)] = _base.size();
+    _base.push(p);
+  }
+
+  _state[var(p)] = _PRESENT_;
+  _dirty = true;
+}
+
+void AssumptionSet::remove(Lit p) {
+  if (!has(p))
+    return;
+
+  _state[var(p)] = _REMOVED_;
+  _nRemoved++;
+  _dirty = true;
+}
+
+void AssumptionSet::setTail(vec<Lit> &tail) {
+  tail.copyTo(_tail);
+  _dirty = true;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  lits : [void] ->  [vec<Lit>&]
+  |
+  |  Description:
+  |
+  |    Returns the assumptions followed by the tail. The removed literals are
+  |    only dropped from '_base' here, once per SAT call, preserving the order
+  |    of the remaining ones.
+  |
+  |________________________________________________________________________________________________@*/
+vec<Lit> &AssumptionSet::lits() {
+  if (!_dirty)
+    return _lits;
+
+  if (_nRemoved > 0) {
+    int j = 0;
+    for (int i = 0; i < _base.size(); i++) {
+      int v = var(_base[i]);
+      if (_index[v] != i)
+        continue; // Replaced by a literal of the opposite sign.
+      if (_state[v] == _PRESENT_) {
+        _index[v] = j;
+        _base[j++] = _base[i];
+      } else
+        _state[v] = _ABSENT_;
+    }
+    _base.shrink(_base.size() - j);
+    _nRemoved = 0;
+  }
+
+  _base.copyTo(_lits);
+  for (int i = 0; i < _tail.size(); i++)
+    _lits.push(_tail[i]);
+
+  _dirty = false;
+  return _lits;
+}
@@ -0,0 +1,87 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#ifndef ASSUMPTION_SET_H
+#define ASSUMPTION_SET_H
+
+#include "core/SolverTypes.h"
+#include "mtl/Vec.h"
+
+using NSPACE::Lit;
+using NSPACE::vec;
+
+namespace upmax {
+
+// Assumptions of the core-guided algorithms, kept across SAT calls.
+// Literals are indexed by variable such that adding and removing a literal
+// is constant time, i.e. processing a core only depends on its size. Removed
+// literals are dropped lazily, preserving the order in which the remaining
+// ones were added. A tail of assumptions (e.g. the ones that restrict the
+// right-hand side of an encoding) can be replaced as a whole after each core.
+// A variable has at most one literal in the set: adding the negation of an
+// assumption replaces it.
+class AssumptionSet {
+
+public:
+  AssumptionSet() : _nRemoved(0), _dirty(false) {}
+
+  void clear();
+
+  void add(Lit p);
+  void remove(Lit p);
+  inline bool has(Lit p) {
+    return var(p) < _state.size() && _state[var(p)] == _PRESENT_ &&
+           _base[_index[var(p)]] == p;
+  }
+
+  // Replaces the tail with 'tail'.
+  void setTail(vec<Lit> &tail);
+
+  // Number of assumptions, including the tail.
+  inline int size() { return _base.size() - _nRemoved + _tail.size(); }
+
+  // Assumptions to be given to the SAT solver.
+  vec<Lit> &lits();
+
+protected:
+  enum { _ABSENT_ = 0, _PRESENT_, _REMOVED_ };
+
+  vec<Lit> _base;    // Added literals, including the ones pending removal.
+  vec<Lit> _tail;    // Tail of assumptions.
+  vec<Lit> _lits;    // Assumptions given to the SAT solver.
+  vec<char> _state;  // State of each variable in '_base'.
+  vec<int> _index;   // Position of the last literal of each variable in
+                     // '_base' (older ones are pending removal).
+  int _nRemoved;     // Literals in '_base' pending removal.
+  bool _dirty;       // '_lits' must be rebuilt.
+};
+
+} // namespace upmax
+
+#endif // ASSUMPTION_SET_H
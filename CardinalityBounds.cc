@@ -0,0 +1,88 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#include "CardinalityBounds.h"
+
+using namespace upmax;
+
+void CardinalityBounds::grow(int v) {
+  if (v < _id.size())
+    return;
+
+  _id.growTo(v + 1, -1);
+  _bound.growTo(v + 1, 0);
+  _weight.growTo(v + 1, 0);
+  _active.growTo(v + 1, false);
+  _prev.growTo(v + 1, lit_Undef);
+  _next.growTo(v + 1, lit_Undef);
+}
+
+void CardinalityBounds::set(Lit p, int id, uint64_t bound, uint64_t weight) {
+  grow(var(p));
+  _id[var(p)] = id;
+  _bound[var(p)] = bound;
+  _weight[var(p)] = weight;
+}
+
+// Appends 'p' to the end of the active list.
+void CardinalityBounds::activate(Lit p) {
+  assert(has(p));
+  if (_active[var(p)])
+    return;
+
+  _active[var(p)] = true;
+  _prev[var(p)] = _last;
+  _next[var(p)] = lit_Undef;
+  if (_last == lit_Undef)
+    _first = p;
+  else
+    _next[var(_last)] = p;
+  _last = p;
+  _nActive++;
+}
+
+// Unlinks 'p' from the active list.
+void CardinalityBounds::deactivate(Lit p) {
+  assert(isActive(p));
+  Lit prev = _prev[var(p)];
+  Lit next = _next[var(p)];
+
+  if (prev == lit_Undef)
+    _first = next;
+  else
+    _next[var(prev)] = next;
+
+  if (next == lit_Undef)
+    _last = prev;
+  else
+    _prev[var(next)] = prev;
+
+  _active[var(p)] = false;
+  _nActive--;
+}
@@ -0,0 +1,93 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#ifndef CARDINALITY_BOUNDS_H
+#define CARDINALITY_BOUNDS_H
+
+#include "core/SolverTypes.h"
+#include "mtl/Vec.h"
+#include <stdint.h>
+
+using NSPACE::Lit;
+using NSPACE::lit_Undef;
+using NSPACE::vec;
+
+namespace upmax {
+
+// Soft cardinality constraints created by core-guided algorithms (OLL).
+// Each output literal of a cardinality constraint that is used as an
+// assumption is mapped, by its variable, to the index of the constraint, the
+// bound it enforces and its weight. The outputs that are currently assumed
+// are kept in an intrusive list, in the order they were activated, with
+// constant time insertion and removal.
+class CardinalityBounds {
+
+public:
+  CardinalityBounds() : _first(lit_Undef), _last(lit_Undef), _nActive(0) {}
+
+  // Maps the output 'p' to constraint 'id' with bound 'bound' and weight
+  // 'weight'.
+  void set(Lit p, int id, uint64_t bound, uint64_t weight);
+
+  inline bool has(Lit p) {
+    return var(p) < _id.size() && _id[var(p)] != -1;
+  }
+  inline int id(Lit p) { return _id[var(p)]; }
+  inline uint64_t bound(Lit p) { return _bound[var(p)]; }
+  inline uint64_t weight(Lit p) { return _weight[var(p)]; }
+  inline void setWeight(Lit p, uint64_t w) { _weight[var(p)] = w; }
+
+  // Active outputs. Iterate with:
+  //   for (Lit p = first(); p != lit_Undef; p = next(p))
+  void activate(Lit p);
+  void deactivate(Lit p);
+  inline bool isActive(Lit p) { return has(p) && _active[var(p)]; }
+  inline int nActive() { return _nActive; }
+  inline Lit first() { return _first; }
+  inline Lit next(Lit p) { return _next[var(p)]; }
+
+protected:
+  void grow(int v);
+
+  // Indexed by variable.
+  vec<int> _id;          // Cardinality constraint of each output (-1 if none).
+  vec<uint64_t> _bound;  // Bound enforced by each output.
+  vec<uint64_t> _weight; // Weight of each output.
+  vec<bool> _active;     // Output is currently assumed.
+  vec<Lit> _prev;        // Previous active output.
+  vec<Lit> _next;        // Next active output.
+
+  Lit _first;
+  Lit _last;
+  int _nActive;
+};
+
+} // namespace upmax
+
+#endif // CARDINALITY_BOUNDS_H
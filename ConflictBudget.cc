@@ -0,0 +1,109 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "ConflictBudget.h"
+
+#include <algorithm>
+#include <inttypes.h>
+
+using namespace upmax;
+
+void ConflictBudget::start(Solver *S, int p) {
+  if (_limit == -1) {
+    S->budgetOff();
+    return;
+  }
+
+  _stats.growTo(p + 1);
+  PartitionStats &stats = _stats[p];
+  if (stats.limit == -1)
+    stats.limit = _limit;
+
+  _given = stats.limit + stats.carry;
+  _conflicts = S->conflicts;
+  _partition = p;
+  _started = true;
+  S->setConfBudget(_given);
+
+  stats.calls++;
+  stats.budget = _given;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  finish : (S : Solver *) (res : lbool)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Updates the statistics of the partition of the call. With an adaptive
+  |    budget, a core means the partition is making progress and its budget
+  |    grows (up to 8 times '-limit'), while a call that runs out of
+  |    conflicts shrinks it (down to 1/16 of '-limit'). The conflicts left by
+  |    a call are carried over to the next one, up to the budget itself.
+  |
+  |________________________________________________________________________________________________@*/
+void ConflictBudget::finish(Solver *S, lbool res) {
+  if (!_started)
+    return;
+  _started = false;
+
+  int64_t used = S->conflicts - _conflicts;
+  PartitionStats &stats = _stats[_partition];
+  stats.conflicts += used;
+  if (res == l_False)
+    stats.cores++;
+  else if (res == l_Undef)
+    stats.timeouts++;
+
+  if (!_adaptive)
+    return;
+
+  if (res == l_False)
+    stats.limit = std::min(stats.limit * 2, _limit * 8);
+  else if (res == l_Undef)
+    stats.limit = std::max(stats.limit / 2, std::max<int64_t>(_limit / 16, 1));
+
+  stats.carry = res == l_Undef ? 0 : _given - used;
+  if (stats.carry < 0)
+    stats.carry = 0;
+  if (stats.carry > stats.limit)
+    stats.carry = stats.limit;
+}
+
+void ConflictBudget::serialize(FILE *file) {
+  fprintf(file, "[");
+  for (int i = 0; i < _stats.size(); i++) {
+    fprintf(file,
+            "%s\n  {\"partition\" : %d, \"calls\" : %d, \"cores\" : %d, "
+            "\"timeouts\" : %d, \"conflicts\" : %" PRIu64
+            ", \"budget\" : %" PRId64 "}",
+            i > 0 ? "," : "", i, _stats[i].calls, _stats[i].cores,
+            _stats[i].timeouts, _stats[i].conflicts, _stats[i].budget);
+  }
+  fprintf(file, "\n]");
+}
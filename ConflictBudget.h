@@ -0,0 +1,94 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef CONFLICT_BUDGET_H
+#define CONFLICT_BUDGET_H
+
+#ifdef SIMP
+#include "simp/SimpSolver.h"
+#else
+#include "core/Solver.h"
+#endif
+
+#include <stdio.h>
+
+using NSPACE::Solver;
+using NSPACE::lbool;
+using NSPACE::vec;
+
+namespace upmax {
+
+// Conflict budget of the SAT calls on the partitions that are not the last
+// one (see '-limit'). With a fixed budget, every call gets the same limit.
+// With an adaptive budget, each partition starts with the limit, which is
+// doubled after each core (up to 8 times the limit) and halved after a call
+// that runs out of conflicts (down to 1/16 of the limit). The conflicts left
+// by a call are added to the next call on the same partition.
+class ConflictBudget {
+
+public:
+  ConflictBudget()
+      : _limit(-1), _adaptive(false), _given(0), _started(false) {}
+
+  void setLimit(int64_t limit) { _limit = limit; }
+  void setAdaptive(bool adaptive) { _adaptive = adaptive; }
+
+  // Sets the budget of the next SAT call of 'S' on partition 'p'.
+  void start(Solver *S, int p);
+  // Records the result of the SAT call that followed 'start'.
+  void finish(Solver *S, lbool res);
+
+  // Budget statistics of each partition as a JSON array.
+  void serialize(FILE *file);
+
+protected:
+  struct PartitionStats {
+    int calls = 0;
+    int cores = 0;
+    int timeouts = 0;
+    uint64_t conflicts = 0;
+    int64_t budget = 0; // Budget of the last call.
+    int64_t limit = -1; // Budget of the next call before the carry.
+    int64_t carry = 0;  // Conflicts left by the previous calls.
+  };
+
+  int64_t _limit;
+  bool _adaptive;
+
+  // Current call
+  int64_t _given;
+  uint64_t _conflicts; // Conflicts of the solver when the call started.
+  int _partition;
+  bool _started;
+
+  vec<PartitionStats> _stats;
+};
+
+} // namespace upmax
+
+#endif // CONFLICT_BUDGET_H
@@ -0,0 +1,316 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "LocalSearch.h"
+#include "mtl/Sort.h"
+
+using namespace upmax;
+
+// Variables sampled when picking the best variable to flip.
+#define BMS_SAMPLES 15
+// Increment of the weight of falsified hard clauses when stuck.
+#define HARD_INC 3
+// Bound on the weight of soft clauses (in units of their increment).
+#define SOFT_LIMIT 500
+
+LocalSearch::LocalSearch(MaxSATFormula *mx)
+    : _nVars(mx->nInitialVars()), _constCost(0), _nHardFalsified(0),
+      _softCost(0), _seed(1), _nFlips(0) {
+  _occurs.growTo(_nVars);
+
+  uint64_t sumCost = 0;
+  int nSoft = 0;
+  for (int i = 0; i < mx->nHard() + mx->nSoft(); i++) {
+    bool hard = i < mx->nHard();
+    vec<Lit> &clause = hard ? mx->getHardClause(i).clause
+                            : mx->getSoftClause(i - mx->nHard()).clause;
+
+    uint64_t weight = hard ? 0 : mx->getSoftClause(i - mx->nHard()).weight;
+    if (!hard && weight == 0)
+      continue;
+
+    bool original = true;
+    for (int j = 0; j < clause.size() && original; j++)
+      original = var(clause[j]) < _nVars;
+    if (!original)
+      continue;
+
+    // Empty soft clauses are falsified by every assignment.
+    if (!hard && clause.size() == 0) {
+      _constCost += weight;
+      continue;
+    }
+
+    // Duplicated literals are removed and tautologies are skipped.
+    clause.copyTo(_clause);
+    sort(_clause);
+    int k = 0;
+    bool tautology = false;
+    for (int j = 0; j < _clause.size(); j++) {
+      if (k > 0 && _clause[j] == _clause[k - 1])
+        continue;
+      if (k > 0 && _clause[j] == ~_clause[k - 1])
+        tautology = true;
+      _clause[k++] = _clause[j];
+    }
+    if (tautology)
+      continue;
+    _clause.shrink(_clause.size() - k);
+
+    int c = _start.size();
+    _start.push(_lits.size());
+    for (int j = 0; j < _clause.size(); j++) {
+      _lits.push(_clause[j]);
+      _occurs[var(_clause[j])].push(c);
+    }
+    _cost.push(weight);
+    if (!hard) {
+      sumCost += _cost.last();
+      nSoft++;
+    }
+  }
+  _start.push(_lits.size());
+
+  // Soft clauses are weighted up relative to their average weight.
+  uint64_t average = nSoft > 0 ? sumCost / nSoft : 1;
+  if (average == 0)
+    average = 1;
+  _increment.growTo(_cost.size());
+  for (int c = 0; c < _cost.size(); c++) {
+    _increment[c] = _cost[c] == 0 ? HARD_INC : _cost[c] / average;
+    if (_increment[c] == 0)
+      _increment[c] = 1;
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  search : (model : vec<lbool>&) (cost : uint64_t&) (flips : uint64_t)
+  |           ->  [bool]
+  |
+  |  Description:
+  |
+  |    Flips the variable with the best score out of a sample of the
+  |    variables with positive score. If there is none, the weights of the
+  |    falsified clauses are increased and the best variable of a random
+  |    falsified clause is flipped.
+  |
+  |  Pre-conditions:
+  |    * 'model' assigns at least the variables of the original formula.
+  |
+  |________________________________________________________________________________________________@*/
+bool LocalSearch::search(vec<lbool> &model, uint64_t &cost, uint64_t flips) {
+  init(model);
+
+  bool improved = false;
+  for (uint64_t i = 0; i < flips; i++) {
+    if (_nHardFalsified == 0 && _softCost < cost) {
+      cost = _softCost;
+      for (int v = 0; v < _nVars; v++)
+        model[v] = _value[v] ? l_True : l_False;
+      improved = true;
+    }
+    if (_falsified.size() == 0)
+      break;
+
+    int v = pickVar();
+    if (v == -1)
+      break;
+    flip(v);
+    _nFlips++;
+  }
+
+  if (_nHardFalsified == 0 && _softCost < cost) {
+    cost = _softCost;
+    for (int v = 0; v < _nVars; v++)
+      model[v] = _value[v] ? l_True : l_False;
+    improved = true;
+  }
+  return improved;
+}
+
+void LocalSearch::init(vec<lbool> &model) {
+  int nClauses = _cost.size();
+
+  _value.growTo(_nVars);
+  for (int v = 0; v < _nVars; v++)
+    _value[v] = model[v] == l_True;
+
+  _weight.growTo(nClauses);
+  _nTrue.growTo(nClauses);
+  _trueVar.growTo(nClauses);
+  _falsifiedPos.growTo(nClauses);
+  _score.growTo(_nVars);
+  _goodPos.growTo(_nVars);
+  for (int v = 0; v < _nVars; v++) {
+    _score[v] = 0;
+    _goodPos[v] = -1;
+  }
+  _falsified.clear();
+  _good.clear();
+  _nHardFalsified = 0;
+  _softCost = _constCost;
+
+  for (int c = 0; c < nClauses; c++) {
+    _weight[c] = _increment[c];
+    _nTrue[c] = 0;
+    _trueVar[c] = -1;
+    _falsifiedPos[c] = -1;
+    for (int j = _start[c]; j < _start[c + 1]; j++)
+      if (isTrue(_lits[j])) {
+        _nTrue[c]++;
+        _trueVar[c] = var(_lits[j]);
+      }
+
+    if (_nTrue[c] == 0) {
+      falsify(c);
+      for (int j = _start[c]; j < _start[c + 1]; j++)
+        _score[var(_lits[j])] += _weight[c];
+    } else if (_nTrue[c] == 1)
+      _score[_trueVar[c]] -= _weight[c];
+  }
+
+  for (int v = 0; v < _nVars; v++)
+    addScore(v, 0);
+}
+
+// Updates the score of 'v' and whether it is a candidate to be flipped.
+void LocalSearch::addScore(int v, int64_t delta) {
+  _score[v] += delta;
+  if (_score[v] > 0 && _goodPos[v] == -1) {
+    _goodPos[v] = _good.size();
+    _good.push(v);
+  } else if (_score[v] <= 0 && _goodPos[v] != -1) {
+    int last = _good.last();
+    _good[_goodPos[v]] = last;
+    _goodPos[last] = _goodPos[v];
+    _good.pop();
+    _goodPos[v] = -1;
+  }
+}
+
+void LocalSearch::falsify(int c) {
+  _falsifiedPos[c] = _falsified.size();
+  _falsified.push(c);
+  if (_cost[c] == 0)
+    _nHardFalsified++;
+  else
+    _softCost += _cost[c];
+}
+
+void LocalSearch::satisfy(int c) {
+  int last = _falsified.last();
+  _falsified[_falsifiedPos[c]] = last;
+  _falsifiedPos[last] = _falsifiedPos[c];
+  _falsified.pop();
+  _falsifiedPos[c] = -1;
+  if (_cost[c] == 0)
+    _nHardFalsified--;
+  else
+    _softCost -= _cost[c];
+}
+
+void LocalSearch::flip(int v) {
+  _value[v] = !_value[v];
+
+  for (int i = 0; i < _occurs[v].size(); i++) {
+    int c = _occurs[v][i];
+    int64_t w = _weight[c];
+
+    bool becameTrue = false;
+    for (int j = _start[c]; j < _start[c + 1]; j++)
+      if (var(_lits[j]) == v && isTrue(_lits[j]))
+        becameTrue = true;
+
+    if (becameTrue) {
+      _nTrue[c]++;
+      if (_nTrue[c] == 1) {
+        // No variable makes 'c' satisfied anymore and 'v' now breaks it.
+        satisfy(c);
+        for (int j = _start[c]; j < _start[c + 1]; j++)
+          addScore(var(_lits[j]), -w);
+        addScore(v, -w);
+        _trueVar[c] = v;
+      } else if (_nTrue[c] == 2)
+        addScore(_trueVar[c], w);
+    } else {
+      _nTrue[c]--;
+      if (_nTrue[c] == 0) {
+        falsify(c);
+        for (int j = _start[c]; j < _start[c + 1]; j++)
+          addScore(var(_lits[j]), w);
+        addScore(v, w);
+      } else if (_nTrue[c] == 1) {
+        for (int j = _start[c]; j < _start[c + 1]; j++)
+          if (isTrue(_lits[j])) {
+            _trueVar[c] = var(_lits[j]);
+            break;
+          }
+        addScore(_trueVar[c], -w);
+      }
+    }
+  }
+}
+
+// Increases the weight of the falsified hard clauses, and of the falsified
+// soft clauses below their bound.
+void LocalSearch::updateWeights() {
+  for (int i = 0; i < _falsified.size(); i++) {
+    int c = _falsified[i];
+    if (_cost[c] != 0 && _weight[c] >= SOFT_LIMIT * _increment[c])
+      continue;
+    _weight[c] += _increment[c];
+    for (int j = _start[c]; j < _start[c + 1]; j++)
+      addScore(var(_lits[j]), _increment[c]);
+  }
+}
+
+int LocalSearch::pickVar() {
+  if (_good.size() > 0) {
+    int best = -1;
+    int samples = _good.size() < BMS_SAMPLES ? _good.size() : BMS_SAMPLES;
+    for (int i = 0; i < samples; i++) {
+      int v = _good.size() <= BMS_SAMPLES ? _good[i]
+                                          : _good[nextRandom() % _good.size()];
+      if (best == -1 || _score[v] > _score[best])
+        best = v;
+    }
+    return best;
+  }
+
+  updateWeights();
+
+  int c = _falsified[nextRandom() % _falsified.size()];
+  int best = -1;
+  for (int j = _start[c]; j < _start[c + 1]; j++) {
+    int v = var(_lits[j]);
+    if (best == -1 || _score[v] > _score[best])
+      best = v;
+  }
+  return best;
+}
@@ -0,0 +1,111 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include "MaxSATFormula.h"
+
+using NSPACE::Lit;
+using NSPACE::lbool;
+using NSPACE::vec;
+
+namespace upmax {
+
+// Weighted local search with dynamic clause weights, in the style of
+// SATLike. Scores are the weighted number of clauses made satisfied minus
+// the ones made falsified by flipping a variable. Hard clauses are weighted
+// up whenever the search gets stuck, such that it is pushed back towards
+// assignments that satisfy them.
+//
+// Only the clauses over the variables of the original formula are used, so
+// the clauses added by the algorithms (e.g. relaxation of cores) are ignored.
+// Soft clauses split by OLL are kept with their remaining weights, which
+// add up to the original weight.
+class LocalSearch {
+
+public:
+  LocalSearch(MaxSATFormula *mx);
+
+  // Starts from 'model' and flips at most 'flips' variables. If an
+  // assignment that satisfies all hard clauses and costs less than 'cost' is
+  // found, the best one is stored in 'model' and 'cost' and true is returned.
+  bool search(vec<lbool> &model, uint64_t &cost, uint64_t flips);
+
+  uint64_t nFlips() { return _nFlips; }
+
+protected:
+  void init(vec<lbool> &model);
+  void flip(int v);
+  void updateWeights();
+  int pickVar();
+
+  void addScore(int v, int64_t delta);
+  void satisfy(int c);
+  void falsify(int c);
+
+  bool isTrue(Lit l) { return _value[var(l)] != sign(l); }
+  unsigned nextRandom() {
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+    return _seed;
+  }
+
+  int _nVars;
+
+  // Clauses stored consecutively in '_lits'.
+  vec<Lit> _lits;
+  vec<int> _start;     // First literal of each clause (and one past the last).
+  vec<uint64_t> _cost; // Weight of soft clauses (0 for hard clauses).
+  vec<int64_t> _increment; // Increment of the dynamic weight of each clause.
+  vec<vec<int>> _occurs; // Clauses of each variable.
+  uint64_t _constCost;   // Weight of the empty soft clauses.
+  vec<Lit> _clause;
+
+  // Search state
+  vec<bool> _value;
+  vec<int64_t> _weight; // Dynamic clause weights.
+  vec<int> _nTrue;      // Number of true literals of each clause.
+  vec<int> _trueVar;    // Variable of the true literal if '_nTrue' is 1.
+  vec<int64_t> _score;
+
+  vec<int> _falsified; // Falsified clauses.
+  vec<int> _falsifiedPos;
+  vec<int> _good;      // Variables with positive score.
+  vec<int> _goodPos;
+  int _nHardFalsified;
+  uint64_t _softCost; // Weight of the falsified soft clauses.
+
+  unsigned _seed;
+  uint64_t _nFlips;
+};
+
+} // namespace upmax
+
+#endif // LOCAL_SEARCH_H
@@ -31,8 +31,10 @@
 #include "utils/Options.h"
 #include "utils/ParseUtils.h"
 #include "utils/System.h"
+#include <dirent.h>
 #include <errno.h>
 #include <signal.h>
+#include <sys/stat.h>
 #include <zlib.h>
 
 #include <fstream>
@@ -41,6 +43,9 @@
 #include <stdlib.h>
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include "core/Solver.h"
 
@@ -51,6 +56,7 @@
 #include "ParserPartitions.h"
 
 #include "MaxSAT_Partition.h"
+#include "Portfolio.h"
 
 // Algorithms
 #include "algorithms/Alg_MSU3.h"
@@ -61,6 +67,7 @@
 #include "algorithms/Alg_UpWBO.h"
 #include "algorithms/Alg_WMSU3.h"
 #include "algorithms/Alg_UpWMSU3.h"
+#include "algorithms/Alg_UpLNS.h"
 
 #define VER1_(x) #x
 #define VER_(x) VER1_(x)
@@ -79,12 +86,174 @@ using namespace upmax;
 //=================================================================================================
 
 static MaxSAT *mxsolver;
+static Portfolio *mxportfolio = NULL;
 
 static void SIGINT_exit(int signum) {
-  mxsolver->printAnswer(_UNKNOWN_);
+  if (mxportfolio != NULL)
+    mxportfolio->printAnswer(_UNKNOWN_);
+  else
+    mxsolver->printAnswer(_UNKNOWN_);
   exit(_UNKNOWN_);
 }
 
+//=================================================================================================
+// Partition extraction (-upfile and -upbatch):
+
+typedef struct {
+  int formula;
+  int graph_type;
+  int split_mode;
+  int partitions;
+  double imbalance;
+  bool wcnf;
+} SplitOptions;
+
+// Splits a parsed formula and writes it to a pwcnf file (or to a wcnf file
+// if the option wcnf is set). The formula is deleted.
+static void splitFormula(MaxSATFormula *maxsat_formula,
+                         const std::string &output, SplitOptions &opt) {
+  MaxSAT_Partition *mp = new MaxSAT_Partition();
+  mp->loadFormula(maxsat_formula);
+  mp->init();
+  if (opt.wcnf) {
+    mp->split(PWCNF_MODE);
+    mp->printPWCNFtoFile(output, opt.wcnf);
+  } else {
+    mp->setRandomPartitions(opt.partitions);
+    mp->setBalancedPartitions(opt.partitions);
+    mp->setImbalance(opt.imbalance);
+    if (opt.graph_type == 3) {
+      // random
+      mp->split(RAND_MODE);
+    } else if (opt.split_mode == 1)
+      mp->split(MULTILEVEL_MODE, opt.graph_type);
+    else if (opt.split_mode == 2)
+      mp->split(STREAM_MODE);
+    else
+      mp->split(UNFOLDING_MODE, opt.graph_type);
+    mp->printPWCNFtoFile(output);
+  }
+  delete mp;
+}
+
+// Parses and splits a single file. Returns false if the file cannot be
+// opened.
+static bool splitFile(const std::string &input, const std::string &output,
+                      SplitOptions &opt) {
+  gzFile in = gzopen(input.c_str(), "rb");
+  if (in == NULL)
+    return false;
+
+  MaxSATFormula *maxsat_formula = new MaxSATFormula();
+  Stream_Partitioner *stream = NULL;
+
+  if (opt.formula == _FORMAT_MAXSAT_) {
+    stream = new Stream_Partitioner(opt.partitions);
+    parseMaxSATFormula(in, maxsat_formula, stream);
+    maxsat_formula->setFormat(_FORMAT_MAXSAT_);
+  } else if (opt.formula == _FORMAT_PB_) {
+    ParserPB *parser_pb = new ParserPB();
+    parser_pb->parsePBFormula((char *)input.c_str(), maxsat_formula);
+    maxsat_formula->setFormat(_FORMAT_PB_);
+    delete parser_pb;
+  } else {
+    parsePwcnfFormula(in, maxsat_formula);
+    maxsat_formula->setFormat(_FORMAT_PWCNF_);
+  }
+  gzclose(in);
+
+  splitFormula(maxsat_formula, output, opt);
+  if (stream != NULL)
+    delete stream;
+  return true;
+}
+
+// Input files are either the files in a directory or the lines of a file.
+static void batchInputs(const char *path, std::vector<std::string> &inputs) {
+  struct stat st;
+  if (stat(path, &st) != 0) {
+    printf("c ERROR! Could not open batch: %s\n", path);
+    printf("s UNKNOWN\n");
+    exit(_ERROR_);
+  }
+
+  if (S_ISDIR(st.st_mode)) {
+    DIR *dir = opendir(path);
+    struct dirent *entry;
+    while (dir != NULL && (entry = readdir(dir)) != NULL) {
+      std::string file = std::string(path) + "/" + entry->d_name;
+      if (entry->d_name[0] != '.' && stat(file.c_str(), &st) == 0 &&
+          S_ISREG(st.st_mode))
+        inputs.push_back(file);
+    }
+    if (dir != NULL)
+      closedir(dir);
+    std::sort(inputs.begin(), inputs.end());
+  } else {
+    std::ifstream list(path);
+    std::string line;
+    while (std::getline(list, line))
+      if (!line.empty())
+        inputs.push_back(line);
+  }
+}
+
+// Output file has the name of the input file with a pwcnf (or wcnf)
+// extension, in the output directory if one is given.
+static std::string batchOutput(const std::string &input, const char *dir,
+                               bool wcnf) {
+  std::string name = input;
+  if (dir != NULL) {
+    size_t slash = name.find_last_of('/');
+    if (slash != std::string::npos)
+      name = name.substr(slash + 1);
+    name = std::string(dir) + "/" + name;
+  }
+
+  const char *extensions[] = {".gz", ".wcnf", ".pwcnf", ".cnf", ".opb"};
+  for (int i = 0; i < 5; i++) {
+    size_t len = strlen(extensions[i]);
+    if (name.size() > len &&
+        name.compare(name.size() - len, len, extensions[i]) == 0)
+      name = name.substr(0, name.size() - len);
+  }
+
+  return name + (wcnf ? ".wcnf" : ".pwcnf");
+}
+
+// Converts all inputs with a pool of workers. Each worker converts one file
+// at a time and releases it before taking the next one. Inputs that would be
+// overwritten by their output (e.g. pwcnf files without '-updir') fail.
+static void splitBatch(std::vector<std::string> &inputs, const char *dir,
+                       int workers, SplitOptions &opt) {
+  std::atomic<int> next(0);
+  std::atomic<int> failed(0);
+  std::vector<std::thread> pool;
+
+  for (int w = 0; w < workers; w++)
+    pool.push_back(std::thread([&]() {
+      for (int i = next++; i < (int)inputs.size(); i = next++) {
+        std::string output = batchOutput(inputs[i], dir, opt.wcnf);
+        if (output == inputs[i]) {
+          printf("c ERROR! Output would overwrite the input file: %s\n",
+                 inputs[i].c_str());
+          failed++;
+        } else if (splitFile(inputs[i], output, opt))
+          printf("c Converted %s to %s\n", inputs[i].c_str(), output.c_str());
+        else {
+          printf("c ERROR! Could not open file: %s\n", inputs[i].c_str());
+          failed++;
+        }
+      }
+    }));
+
+  for (size_t w = 0; w < pool.size(); w++)
+    pool[w].join();
+
+  printf("c Batch: %d files converted, %d failed\n",
+         (int)inputs.size() - (int)failed, (int)failed);
+}
+
 //=================================================================================================
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 void limitMemory(uint64_t max_mem_mb)
@@ -174,7 +343,80 @@ int main(int argc, char **argv) {
     StringOption json ("UpMax", "json", "JSON search statistics output destination\n", NULL);
 
     IntOption pwcnf_limit("UpMax","limit","Conflict limit for each partition.\n",-1,IntRange(-1,INT32_MAX));
+    BoolOption adaptive_limit("UpMax", "adaptive-limit",
+                              "Grow the conflict limit of partitions with "
+                              "cores and shrink it otherwise.\n",
+                              false);
     IntOption pwcnf_mode("UpMax","merge","Merge heuristic (0=partition size,1=core size,2=saturation only).\n",0,IntRange(0,2));
+    IntOption pwcnf_order("UpMax","order","Order of partitions (0=size,1=weight,2=adjacency,3=core density).\n",0,IntRange(0,3));
+    BoolOption merge_tree("UpMax","merge-tree","Solve partitions independently and merge them in a tree (msu3).\n",false);
+
+    IntOption parallel("UpMax", "parallel",
+                       "Number of threads extracting cores of partitions "
+                       "before solving all partitions (0=none, msu3 and "
+                       "unweighted oll).\n",
+                       0, IntRange(0, INT32_MAX));
+
+    IntOption lsu("UpMax", "lsu",
+                  "Seconds before msu3 switches to linear search (-1=never, "
+                  "0=once all partitions are active).\n",
+                  -1, IntRange(-1, INT32_MAX));
+
+    BoolOption incremental_pb("UpMax", "incremental-pb",
+                              "Keep one solver and extend the PB encoding "
+                              "with each core (weighted msu3).\n",
+                              false);
+
+    IntOption up_strat("UpMax", "up-strat",
+                       "Stratification of weighted formulas in oll "
+                       "(0=none,1=strata within each partition,2=partitions "
+                       "within each stratum).\n",
+                       0, IntRange(0, 2));
+
+    BoolOption portfolio("UpMax", "portfolio",
+                         "Run wbo, msu3 and oll in parallel and stop when "
+                         "one of them finishes.\n",
+                         false);
+
+    BoolOption lns("UpMax", "lns",
+                   "Run a large neighbourhood search over partitions in "
+                   "parallel to find upper bounds.\n",
+                   false);
+
+    IntOption lns_limit("UpMax", "lns-limit",
+                        "Conflict limit for each neighbourhood of the large "
+                        "neighbourhood search.\n",
+                        1000, IntRange(1, INT32_MAX));
+
+    IntOption ls_flips("UpMax", "ls-flips",
+                       "Flips of local search from each model of the Up* "
+                       "algorithms (0=none).\n",
+                       0, IntRange(0, INT32_MAX));
+
+    BoolOption harden("UpMax", "harden",
+                      "Harden soft clauses whose weight exceeds the gap "
+                      "between the bounds (weighted wbo, msu3 and oll).\n",
+                      false);
+
+    BoolOption sol_phase("UpMax", "sol-phase",
+                         "Use the best model as the phases of the SAT "
+                         "solver.\n",
+                         false);
+
+    IntOption core_min("UpMax", "core-min",
+                       "Core minimization (0=none,1=trimming,2=trimming and "
+                       "destructive minimization).\n",
+                       0, IntRange(0, 2));
+
+    IntOption core_budget("UpMax", "core-budget",
+                          "Conflict limit for each SAT call of core "
+                          "minimization.\n",
+                          1000, IntRange(1, INT32_MAX));
+
+    IntOption core_time("UpMax", "core-time",
+                        "Time limit of core minimization for each core (in "
+                        "percentage of the elapsed time).\n",
+                        10, IntRange(0, 100));
 
     IntOption cpu_lim("UpMax", "cpu-lim",
                       "Limit on CPU time allowed in seconds.\n", 0,
@@ -190,6 +432,25 @@ int main(int argc, char **argv) {
 
     BoolOption wcnf("UpMax", "wcnf", "Transform PWCNF in WCNF file.\n", false); 
 
+    StringOption upbatch("UpMax", "upbatch",
+                         "Directory or list of files to convert with "
+                         "automatic partition.\n",
+                         NULL);
+
+    StringOption updir("UpMax", "updir",
+                       "Output directory of batch conversion.\n", NULL);
+
+    IntOption threads("UpMax", "threads",
+                      "Number of workers of batch conversion (0=number of "
+                      "cores).\n",
+                      0, IntRange(0, INT32_MAX));
+
+    IntOption worker_mem("UpMax", "worker-mem",
+                         "Memory reserved for each worker of batch "
+                         "conversion in megabytes (only bounds the number "
+                         "of workers with mem-lim).\n",
+                         2048, IntRange(1, INT32_MAX));
+
     IntOption algorithm("UpMax", "algorithm",
                         "Search algorithm "
                         "(0=wbo,1=msu3,2=oll)\n",
@@ -197,10 +458,29 @@ int main(int argc, char **argv) {
 
     
     IntOption graph_type("UpMax", "graph-type",
-                         "Graph type (0=vig, 1=cvig, 2=res, 3=random).",
-                         2, IntRange(0, 3));
-
-    BoolOption bmo("UpMax", "bmo", "BMO search.\n", true);
+                         "Graph type (0=vig, 1=cvig, 2=res, 3=random, "
+                         "4=hypergraph).",
+                         2, IntRange(0, 4));
+
+    IntOption split_mode("UpMax", "split",
+                         "Graph split method (0=community unfolding, "
+                         "1=balanced multilevel, 2=streaming).\n",
+                         0, IntRange(0, 2));
+
+    IntOption n_partitions("UpMax", "partitions",
+                           "Number of partitions for random and balanced "
+                           "splits.\n",
+                           16, IntRange(1, INT32_MAX));
+
+    IntOption imbalance("UpMax", "imbalance",
+                        "Allowed imbalance of soft clauses per partition in "
+                        "balanced splits (in percentage).\n",
+                        5, IntRange(0, 100));
+
+    BoolOption bmo("UpMax", "bmo",
+                   "Solve lexicographic formulas one weight at a time "
+                   "(wbo, msu3 and oll).\n",
+                   true);
 
     IntOption cardinality("Encodings", "cardinality",
                           "Cardinality encoding (0=cardinality networks, "
@@ -234,6 +514,37 @@ int main(int argc, char **argv) {
     if (cpu_lim != 0) limitTime(cpu_lim);
     if (mem_lim != 0) limitMemory(mem_lim);
 
+    SplitOptions split_opt;
+    split_opt.formula = formula;
+    split_opt.graph_type = graph_type;
+    split_opt.split_mode = split_mode;
+    split_opt.partitions = n_partitions;
+    split_opt.imbalance = imbalance / 100.0;
+    split_opt.wcnf = wcnf;
+
+    if (upbatch != NULL) {
+      std::vector<std::string> inputs;
+      batchInputs((const char *)upbatch, inputs);
+
+      // Pool is sized to the cores, but never beyond the memory limit. The
+      // workers share the address space, so -worker-mem is not enforced on
+      // each of them: only -mem-lim bounds the whole process.
+      int workers = threads;
+      if (workers == 0)
+        workers = std::thread::hardware_concurrency();
+      if (mem_lim != 0 && workers > mem_lim / worker_mem)
+        workers = mem_lim / worker_mem;
+      if (workers > (int)inputs.size())
+        workers = inputs.size();
+      if (workers < 1)
+        workers = 1;
+
+      printf("c Batch: %d files with %d workers\n", (int)inputs.size(),
+             workers);
+      splitBatch(inputs, (const char *)updir, workers, split_opt);
+      exit(_UNKNOWN_);
+    }
+
     double initial_time = cpuTime();
     MaxSAT *S = NULL;
 
@@ -252,8 +563,13 @@ int main(int argc, char **argv) {
 
     MaxSATFormula *maxsat_formula = new MaxSATFormula();
 
+    // Clauses are also split while parsing, in case the graph is too large
+    Stream_Partitioner *stream = NULL;
+    if (upfile != NULL && (int)formula == _FORMAT_MAXSAT_)
+      stream = new Stream_Partitioner(n_partitions);
+
     if ((int)formula == _FORMAT_MAXSAT_) {
-      parseMaxSATFormula(in, maxsat_formula);
+      parseMaxSATFormula(in, maxsat_formula, stream);
       maxsat_formula->setFormat(_FORMAT_MAXSAT_);
     } else if ((int)formula == _FORMAT_PB_){
       ParserPB *parser_pb = new ParserPB();
@@ -318,70 +634,129 @@ int main(int argc, char **argv) {
 
     
     if (upfile != NULL){
-        MaxSAT_Partition * mp = new MaxSAT_Partition();
-        mp->loadFormula(maxsat_formula);
-        mp->init();
-        if (wcnf){
-            mp->split(PWCNF_MODE);
-            mp->printPWCNFtoFile((const char *) upfile, wcnf);    
-        } else {
-            int graphType = graph_type;
-            if (graphType == 3) {
-                // random
-                mp->split(RAND_MODE);
-            } else mp->split(UNFOLDING_MODE, graphType);
-            mp->printPWCNFtoFile((const char *) upfile);
-        }
+        splitFormula(maxsat_formula, (const char *) upfile, split_opt);
         exit(_UNKNOWN_);
     }
 
 
-    switch ((int)algorithm) {
-    case _ALGORITHM_WBO_:
-      if (upmax){
-        S = new UpWBO(verbosity, pwcnf_mode, pwcnf_limit);
-      } else {
-        S = new WBO(verbosity, weight, symmetry, symmetry_lim);
-      }
-      break;
-
-    
-    case _ALGORITHM_MSU3_:
-        if (upmax){
-            if(maxsat_formula->getProblemType() == _UNWEIGHTED_)
-                S = new UpMSU3(verbosity, pwcnf_mode, pwcnf_limit);
-            else
-                S = new UpWMSU3(verbosity);
+    // With 'up', the partitioned (Up*) variant of 'alg' is created.
+    auto newSolver = [&](int alg, bool up) -> MaxSAT * {
+      MaxSAT *S = NULL;
+      switch (alg) {
+      case _ALGORITHM_WBO_:
+        if (up){
+          S = new UpWBO(verbosity, pwcnf_mode, pwcnf_limit);
         } else {
-            if(maxsat_formula->getProblemType() == _UNWEIGHTED_)
-                S = new MSU3(verbosity);
-            else
-                S = new WMSU3(verbosity);
+          S = new WBO(verbosity, weight, symmetry, symmetry_lim);
         }
-      break;
+        break;
+
+      case _ALGORITHM_MSU3_:
+          if (up){
+              // Lexicographic formulas are a series of unweighted ones.
+              std::vector<uint64_t> weights;
+              if(maxsat_formula->getProblemType() == _UNWEIGHTED_ ||
+                 (bmo && maxsat_formula->isBMO(weights)))
+                  S = new UpMSU3(verbosity, pwcnf_mode, pwcnf_limit, merge_tree,
+                                 parallel, lsu);
+              else
+                  S = new UpWMSU3(verbosity,
+                                  incremental_pb ? _INCREMENTAL_ITERATIVE_
+                                                 : _INCREMENTAL_NONE_,
+                                  _CARD_TOTALIZER_, _PB_SWC_, bmo);
+          } else {
+              if(maxsat_formula->getProblemType() == _UNWEIGHTED_)
+                  S = new MSU3(verbosity);
+              else
+                  S = new WMSU3(verbosity,
+                                incremental_pb ? _INCREMENTAL_ITERATIVE_
+                                               : _INCREMENTAL_NONE_);
+          }
+        break;
+
+      case _ALGORITHM_OLL_:
+          if (up){
+              S = new UpOLL(verbosity, pwcnf_mode, pwcnf_limit, up_strat,
+                            parallel);
+          } else {
+              S = new OLL(verbosity, cardinality);
+          }
+        break;
+
+      case _ALGORITHM_LNS_:
+        S = new UpLNS(verbosity, lns_limit);
+        break;
+
+      default:
+        printf("c Error: Invalid MaxSAT algorithm.\n");
+        printf("s UNKNOWN\n");
+        exit(_ERROR_);
+      }
 
-    case _ALGORITHM_OLL_:
-        if (upmax){
-            S = new UpOLL(verbosity, pwcnf_mode, pwcnf_limit);
-        } else {
-            S = new OLL(verbosity, cardinality);
+      S->setPartitionOrder(pwcnf_order);
+      S->setCoreMinimization(core_min, core_budget, core_time / 100.0);
+      S->setLocalSearch(ls_flips);
+      S->setSolutionPhases(sol_phase);
+      S->setHardening(harden);
+      S->setBMO(bmo);
+      S->setAdaptiveBudget(adaptive_limit);
+      S->setPrintModel(printmodel);
+      S->setPrintSoft((const char *)printsoft);
+      S->setJson((const char *) json);
+      S->setInitialTime(initial_time);
+      S->_all_opt_sols = allopts;
+      S->_all_var_sols = allvars;
+      return S;
+    };
+
+    if (portfolio || lns) {
+      // The algorithms relax the soft clauses of their formula, so each one
+      // gets its own copy.
+      if (maxsat_formula->getFormat() == _FORMAT_PB_) {
+        printf("c Error: Portfolio does not support PB formulas.\n");
+        printf("s UNKNOWN\n");
+        exit(_ERROR_);
+      }
+
+      // The portfolio runs the partitioned and the non-partitioned variant
+      // of each algorithm.
+      vec<int> algorithms;
+      vec<bool> partitioned;
+      if (portfolio) {
+        for (int alg = _ALGORITHM_WBO_; alg <= _ALGORITHM_OLL_; alg++) {
+          algorithms.push(alg);
+          partitioned.push(true);
+          algorithms.push(alg);
+          partitioned.push(false);
         }
-      break;
+      } else {
+        algorithms.push(algorithm);
+        partitioned.push(upmax);
+      }
+      if (lns) {
+        algorithms.push(_ALGORITHM_LNS_);
+        partitioned.push(true);
+      }
+
+      Portfolio *P = new Portfolio();
+      for (int i = 0; i < algorithms.size(); i++) {
+        MaxSAT *S = newSolver(algorithms[i], partitioned[i]);
+        S->loadFormula(maxsat_formula->copyMaxSATFormula());
+        S->setPrint(false);
+        P->add(S);
+      }
+      delete maxsat_formula;
 
-    default:
-      printf("c Error: Invalid MaxSAT algorithm.\n");
-      printf("s UNKNOWN\n");
-      exit(_ERROR_);
+      mxportfolio = P;
+      int ret = (int)P->search();
+      mxportfolio = NULL;
+      delete P;
+      return ret;
     }
 
+    S = newSolver(algorithm, upmax);
     if (S->getMaxSATFormula() == NULL)
       S->loadFormula(maxsat_formula);
-    S->setPrintModel(printmodel);
-    S->setPrintSoft((const char *)printsoft);
-    S->setJson((const char *) json);
-    S->setInitialTime(initial_time);
-    S->_all_opt_sols = allopts;
-    S->_all_var_sols = allvars;
 
     mxsolver = S;
     mxsolver->setPrint(true);
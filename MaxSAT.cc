@@ -27,6 +27,7 @@
  */
 
 #include "MaxSAT.h"
+#include "Portfolio.h"
 #include <signal.h>
 
 #include <sstream>
@@ -101,21 +102,298 @@ lbool MaxSAT::searchSATSolver(Solver *S, vec<Lit> &assumptions, bool pre) {
 // that belong to soft clauses. To preprocessing to be used those variables
 // should be frozen.
 
+  // Solution-guided search: the SAT solver starts from the best model
+  // whenever it changed since the last call.
+  if (solution_phases && model.size() > 0 &&
+      (S != phased_solver || phased_models != nbModels)) {
+    for (int i = 0; i < model.size(); i++)
+      S->setPhase(i, model[i] == l_False);
+    phased_solver = S;
+    phased_models = nbModels;
+  }
+
+  if (portfolio != NULL) {
+    portfolio->updateLB(lbCost);
+    std::lock_guard<std::mutex> guard(search_lock);
+    if (interrupted)
+      throw InterruptException();
+    running = S;
+  }
+
 #ifdef SIMP
   lbool res = ((NSPACE::SimpSolver *)S)->solveLimited(assumptions, pre);
 #else
   lbool res = S->solveLimited(assumptions);
 #endif
 
+  if (portfolio != NULL) {
+    std::lock_guard<std::mutex> guard(search_lock);
+    running = NULL;
+    if (interrupted)
+      throw InterruptException();
+  }
+
   return res;
 }
 
+/*_________________________________________________________________________________________________
+  |
+  |  improveModel : (S : Solver *)  ->  [bool]
+  |
+  |  Description:
+  |
+  |    Runs the local search from the model of 'S' for 'ls_flips' flips. If a
+  |    cheaper assignment is found, it becomes the best model and the phases
+  |    of 'S' are set to it, such that the next SAT calls search close to it.
+  |    The local search only knows the hard and soft clauses, so it is not
+  |    used on formulas with PB or cardinality constraints (e.g. OPB files),
+  |    where its assignments may violate them.
+  |
+  |  Pre-conditions:
+  |    * 'S' has a model.
+  |
+  |  Post-conditions:
+  |    * 'model' and 'ubCost' are updated if the model is improved.
+  |
+  |________________________________________________________________________________________________@*/
+bool MaxSAT::improveModel(Solver *S) {
+  if (ls_flips == 0 || maxsat_formula->nPB() + maxsat_formula->nCard() > 0)
+    return false;
+
+  if (local_search == NULL)
+    local_search = new LocalSearch(maxsat_formula);
+
+  vec<lbool> current;
+  S->model.copyTo(current);
+  uint64_t cost = ubCost;
+  if (!local_search->search(current, cost, ls_flips))
+    return false;
+
+  saveModel(current);
+  printBound(cost);
+  ubCost = cost;
+
+  for (int i = 0; i < maxsat_formula->nInitialVars(); i++)
+    S->setPhase(i, current[i] == l_False);
+  return true;
+}
+
+// A soft clause (or any objective literal) of weight 'weight' can be hardened
+// if every assignment that falsifies it costs at least 'lb' plus its weight,
+// and that is more than the cost of the best model.
+bool MaxSAT::canHarden(uint64_t weight, uint64_t lb) {
+  return hardening && model.size() > 0 && lb <= ubCost &&
+         weight > ubCost - lb;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  hardenSoftClauses : (S : Solver *) (lb : uint64_t) (units : vec<Lit>&)
+  |                      (relaxed : vec<bool> *)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Hardens the soft clauses that no model cheaper than the best one can
+  |    falsify, by adding the negation of their assumption literal to 'S'.
+  |    'lb' must be such that every assignment costs at least 'lb' plus the
+  |    current weights of the soft clauses it falsifies (e.g. the lower bound
+  |    of the reformulations of OLL and WBO, or 0 otherwise). Soft clauses
+  |    marked in 'relaxed' are not part of the objective and are skipped.
+  |    The best model satisfies all hardened soft clauses, so the formula
+  |    stays satisfiable.
+  |
+  |  Post-conditions:
+  |    * 'units' holds the literals added to 'S', which the callers remove
+  |      from their assumptions.
+  |    * 'hardened' and 'nbHardened' are updated.
+  |
+  |________________________________________________________________________________________________@*/
+void MaxSAT::hardenSoftClauses(Solver *S, uint64_t lb, vec<Lit> &units,
+                               vec<bool> *relaxed) {
+  units.clear();
+  if (!hardening || model.size() == 0 || lb > ubCost)
+    return;
+
+  // Weights only decrease, so nothing new can be hardened unless the gap
+  // between the bounds shrinks.
+  uint64_t gap = ubCost - lb;
+  if (gap >= hardened_gap)
+    return;
+  hardened_gap = gap;
+
+  hardened.growTo(maxsat_formula->nSoft(), false);
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    if (hardened[i])
+      continue;
+    if (relaxed != NULL && i < relaxed->size() && (*relaxed)[i])
+      continue;
+    if (!canHarden(maxsat_formula->getSoftClause(i).weight, lb))
+      continue;
+
+    Lit l = ~getAssumptionLit(i);
+    S->addClause(l);
+    units.push(l);
+    hardened[i] = true;
+    nbHardened++;
+  }
+
+  if (verbosity > 0 && units.size() > 0)
+    printf("c Hardened soft clauses : %d (gap %" PRIu64 ")\n", units.size(),
+           gap);
+}
+
+void MaxSAT::addHardened(Solver *S) {
+  for (int i = 0; i < hardened.size(); i++)
+    if (hardened[i])
+      S->addClause(~getAssumptionLit(i));
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  hardenLevel : (S : Solver *) (assumps : vec<Lit>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Adds each literal of 'assumps' to 'S' as a unit clause. Used by the
+  |    lexicographic search once the last SAT call of a weight level is
+  |    satisfiable: the assumptions then fix the optimum of that level, and
+  |    the lighter levels cannot outweigh it.
+  |
+  |  Post-conditions:
+  |    * The soft clauses assumed in 'assumps' are marked in 'hardened'.
+  |
+  |________________________________________________________________________________________________@*/
+void MaxSAT::hardenLevel(Solver *S, vec<Lit> &assumps) {
+  hardened.growTo(maxsat_formula->nSoft(), false);
+  for (int i = 0; i < assumps.size(); i++) {
+    S->addClause(assumps[i]);
+    int soft = softIndex(assumps[i]);
+    if (soft != -1 && !hardened[soft]) {
+      hardened[soft] = true;
+      nbHardened++;
+    }
+  }
+}
+
+// Interrupts the current SAT call, if any, and makes the next ones throw
+// 'InterruptException'. May be called from other threads.
+void MaxSAT::interrupt() {
+  std::lock_guard<std::mutex> guard(search_lock);
+  interrupted = true;
+  if (running != NULL)
+    running->interrupt();
+}
+
 // Solve the formula without assumptions.
 lbool MaxSAT::searchSATSolver(Solver *S, bool pre) {
   vec<Lit> dummy; // Empty set of assumptions.
   return searchSATSolver(S, dummy, pre);
 }
 
+/*_________________________________________________________________________________________________
+  |
+  |  minimizeCore : (S : Solver *) (core : vec<Lit>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Shrinks 'core', a set of literals in the format of 'S->conflict', such
+  |    that the negation of its literals is still unsatisfiable. The core is
+  |    first trimmed and, if '_CORE_MIN_DESTRUCTIVE_' is used, each remaining
+  |    literal is then removed from the core whenever the SAT solver can prove
+  |    the core without it within 'core_budget' conflicts.
+  |
+  |    The time spent on each core is bounded by 'core_time_fraction' of the
+  |    time elapsed so far.
+  |
+  |  Pre-conditions:
+  |    * 'core' may be 'S->conflict' since it is copied before any SAT call.
+  |
+  |  Post-conditions:
+  |    * 'core' is a subset of its original literals.
+  |    * The conflict budget of 'S' is turned off.
+  |    * 'nbMinimizedLits' is increased by the number of removed literals.
+  |
+  |________________________________________________________________________________________________@*/
+void MaxSAT::minimizeCore(Solver *S, vec<Lit> &core) {
+  if (core_minimization == _CORE_MIN_NONE_ || core.size() <= 1)
+    return;
+
+  double now = cpuTime();
+  double limit = now + core_time_fraction * (now - initialTime);
+
+  vec<Lit> current;
+  core.copyTo(current);
+
+  if (trimCore(S, current, limit) &&
+      core_minimization == _CORE_MIN_DESTRUCTIVE_)
+    destructiveMinimization(S, current, limit);
+
+  S->budgetOff();
+  nbMinimizedLits += core.size() - current.size();
+  current.copyTo(core);
+}
+
+// Re-solves with only the core as assumptions while it keeps shrinking.
+// Returns false if the core could not be proved within the budget.
+bool MaxSAT::trimCore(Solver *S, vec<Lit> &core, double limit) {
+  vec<Lit> assumptions;
+  for (int iter = 0; iter < 16 && core.size() > 1 && cpuTime() < limit;
+       iter++) {
+    assumptions.clear();
+    for (int i = 0; i < core.size(); i++)
+      assumptions.push(~core[i]);
+
+    S->setConfBudget(core_budget);
+    lbool res = searchSATSolver(S, assumptions);
+    if (res != l_False || S->conflict.size() == 0)
+      return false;
+
+    if (S->conflict.size() == core.size())
+      return true;
+    S->conflict.copyTo(core);
+  }
+  return true;
+}
+
+// Drops each literal whose removal still leaves an unsatisfiable core.
+void MaxSAT::destructiveMinimization(Solver *S, vec<Lit> &core,
+                                     double limit) {
+  vec<Lit> assumptions;
+  int i = 0;
+  while (i < core.size() && core.size() > 1 && cpuTime() < limit) {
+    assumptions.clear();
+    for (int j = 0; j < core.size(); j++)
+      if (j != i)
+        assumptions.push(~core[j]);
+
+    S->setConfBudget(core_budget);
+    lbool res = searchSATSolver(S, assumptions);
+    if (res != l_False || S->conflict.size() == 0) {
+      // 'core[i]' is needed or the budget was exhausted.
+      i++;
+      continue;
+    }
+
+    // The new conflict may also drop other literals; keep the order of the
+    // remaining ones such that 'i' is the next literal to test.
+    coreSeen.growTo(S->nVars(), false);
+    for (int j = 0; j < S->conflict.size(); j++)
+      coreSeen[var(S->conflict[j])] = true;
+    int k = 0;
+    for (int j = 0; j < core.size(); j++) {
+      if (j == i || !coreSeen[var(core[j])]) {
+        if (j < i)
+          i--;
+        continue;
+      }
+      core[k++] = core[j];
+    }
+    core.shrink(core.size() - k);
+    for (int j = 0; j < S->conflict.size(); j++)
+      coreSeen[var(S->conflict[j])] = false;
+  }
+}
+
 /************************************************************************************************
  //
  // Utils for model management
@@ -142,11 +420,15 @@ void MaxSAT::saveModel(vec<lbool> &currentModel) {
   assert(maxsat_formula->nInitialVars() != 0);
   assert(currentModel.size() != 0);
 
+  nbModels++;
   model.clear();
   // Only store the value of the variables that belong to the
   // original MaxSAT formula.
   for (int i = 0; i < maxsat_formula->nInitialVars(); i++)
     model.push(currentModel[i]);
+
+  if (portfolio != NULL)
+    portfolio->updateUB(portfolio_id, computeCostModel(model), model);
 }
 
 /*_________________________________________________________________________________________________
@@ -221,33 +503,7 @@ uint64_t MaxSAT::computeCostModel(vec<lbool> &currentModel, uint64_t weight) {
   |________________________________________________________________________________________________@*/
 bool MaxSAT::isBMO(bool cache) {
   assert(orderWeights.size() == 0);
-  bool bmo = true;
-  std::set<uint64_t> partitionWeights;
-  std::map<uint64_t, uint64_t> nbPartitionWeights;
-
-  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-    partitionWeights.insert(maxsat_formula->getSoftClause(i).weight);
-    nbPartitionWeights[maxsat_formula->getSoftClause(i).weight]++;
-  }
-
-  for (std::set<uint64_t>::iterator iter = partitionWeights.begin();
-       iter != partitionWeights.end(); ++iter) {
-    orderWeights.push_back(*iter);
-  }
-
-  std::sort(orderWeights.begin(), orderWeights.end(), greaterThan);
-
-  uint64_t totalWeights = 0;
-  for (int i = 0; i < (int)orderWeights.size(); i++)
-    totalWeights += orderWeights[i] * nbPartitionWeights[orderWeights[i]];
-
-  for (int i = 0; i < (int)orderWeights.size(); i++) {
-    totalWeights -= orderWeights[i] * nbPartitionWeights[orderWeights[i]];
-    if (orderWeights[i] < totalWeights) {
-      bmo = false;
-      break;
-    }
-  }
+  bool bmo = maxsat_formula->isBMO(orderWeights);
 
   if (!cache)
     orderWeights.clear();
@@ -451,6 +707,13 @@ void MaxSAT::printStats() {
   printf("c  Nb SAT calls:           %12d\n", nbSatisfiable);
   printf("c  Nb UNSAT calls:         %12d\n", nbCores);
   printf("c  Average core size:      %12.2f\n", avgCoreSize);
+  if (core_minimization != _CORE_MIN_NONE_)
+    printf("c  Minimized literals:     %12" PRIu64 "\n", nbMinimizedLits);
+  if (hardening)
+    printf("c  Hardened soft clauses:  %12d\n", nbHardened);
+  if (local_search != NULL)
+    printf("c  Local search flips:     %12" PRIu64 "\n",
+           local_search->nFlips());
   printf("c  Nb symmetry clauses:    %12d\n", nbSymmetryClauses);
   printf("c\n");
 }
@@ -470,6 +733,10 @@ void MaxSAT::serializeStats(int type) { // TODO: write Python bindings instead
     fprintf(res, "\"num_unsat_calls\" : %d,\n", nbCores);
     fprintf(res, "\"avg_core_size\" : %f,\n", avgCoreSize);
     fprintf(res, "\"num_symmetry_clauses\" : %d,\n", nbSymmetryClauses);
+    fprintf(res, "\"num_hardened\" : %d,\n", nbHardened);
+    fprintf(res, "\"partition_budgets\" : ");
+    conflict_budget.serialize(res);
+    fprintf(res, ",\n");
 
     switch (type) {
     case _SATISFIABLE_:
@@ -572,12 +839,14 @@ uint64_t MaxSAT::getUB() {
   lbool res = searchSATSolver(solver, dummy);
   if (res == l_True) {
     uint64_t ub = computeCostModel(solver->model);
+    delete solver;
     return ub;
   } else if (res == l_False) {
     printAnswer(_UNSATISFIABLE_);
     exit(_UNSATISFIABLE_);
   }
 
+  delete solver;
   return maxsat_formula->nSoft();
 }
 
@@ -607,11 +876,8 @@ std::pair<uint64_t, int> MaxSAT::getLB() {
     solver->addClause(clause);
   }
 
-  std::map<Lit, int> core; // Mapping between the assumption literal and
-                           // the respective soft clause.
-
   for (int i = 0; i < maxsat_formula->nSoft(); i++)
-    core[relaxation_vars[i]] = i;
+    setCoreMapping(relaxation_vars[i], i);
 
   int limit = 1000;
   lbool res = l_False;
@@ -630,12 +896,15 @@ std::pair<uint64_t, int> MaxSAT::getLB() {
     solver->setConfBudget(limit);
     res = searchSATSolver(solver, assumptions);
     if (res == l_False) {
+      // The hard clauses are unsatisfiable.
+      if (solver->conflict.size() == 0)
+        break;
 
       for (int i = 0; i < solver->conflict.size(); i++) {
-        Lit p = solver->conflict[i];
-        if (core.find(p) != core.end()) {
-          assert(!active[core[p]]);
-          active[core[p]] = true;
+        int index_soft = softIndex(solver->conflict[i]);
+        if (index_soft != -1) {
+          assert(!active[index_soft]);
+          active[index_soft] = true;
         }
       }
 
@@ -653,8 +922,11 @@ std::pair<uint64_t, int> MaxSAT::getLB() {
   for (int i = 0; i < relaxation_vars.size(); i++) {
     if (active[i])
       nb_relaxed++;
+    // These variables are not part of the formula.
+    unsetCoreMapping(relaxation_vars[i]);
   }
 
+  delete solver;
   return std::make_pair(lb, nb_relaxed);
 }
 
@@ -31,6 +31,7 @@
 #ifndef MaxSAT_h
 #define MaxSAT_h
 #include <iostream>
+#include <mutex>
 
 #ifdef SIMP
 #include "simp/SimpSolver.h"
@@ -38,6 +39,8 @@
 #include "core/Solver.h"
 #endif
 
+#include "ConflictBudget.h"
+#include "LocalSearch.h"
 #include "MaxSATFormula.h"
 #include "MaxTypes.h"
 #include "utils/System.h"
@@ -57,6 +60,8 @@ using NSPACE::cpuTime;
 
 namespace upmax {
 
+class Portfolio;
+
 class MaxSAT {
 
 public:
@@ -78,6 +83,7 @@ public:
     nbCores = 0;
     nbSatisfiable = 0;
     sumSizeCores = 0;
+    nbMinimizedLits = 0;
 
     print_model = false;
     print_soft = false;
@@ -106,6 +112,7 @@ public:
     nbCores = 0;
     nbSatisfiable = 0;
     sumSizeCores = 0;
+    nbMinimizedLits = 0;
 
     print_model = false;
     print_soft = false;
@@ -120,6 +127,8 @@ public:
   virtual ~MaxSAT() {
     if (maxsat_formula != NULL)
       delete maxsat_formula;
+    if (local_search != NULL)
+      delete local_search;
   }
 
   void setInitialTime(double initial); // Set initial time.
@@ -179,6 +188,44 @@ public:
   bool getPrintModel() { return print_model; }
 
   void setPrint(bool doPrint) { print = doPrint; }
+
+  // Order in which the Up* algorithms add partitions.
+  void setPartitionOrder(int order) { partition_order = order; }
+
+  // Bounds and models are shared with the other solvers of 'p', where this
+  // solver is number 'id'.
+  void setPortfolio(Portfolio *p, int id) {
+    portfolio = p;
+    portfolio_id = id;
+  }
+  // Stops the current and further SAT calls (see 'InterruptException').
+  void interrupt();
+
+  // Local search from each model found by the Up* algorithms (0=none).
+  void setLocalSearch(uint64_t flips) { ls_flips = flips; }
+
+  // The best model is used as the phases of each SAT call.
+  void setSolutionPhases(bool phases) { solution_phases = phases; }
+
+  // Soft clauses that cannot be falsified by a model cheaper than the best
+  // one are hardened by the weighted algorithms.
+  void setHardening(bool harden) { hardening = harden; }
+
+  // Lexicographic formulas are solved one weight at a time by the Up*
+  // algorithms (see 'isBMO').
+  void setBMO(bool bmo) { bmo_search = bmo; }
+
+  // Adapts the conflict limit of the partitions (see 'ConflictBudget').
+  void setAdaptiveBudget(bool adaptive) {
+    conflict_budget.setAdaptive(adaptive);
+  }
+
+  // Core minimization used by the core-guided algorithms.
+  void setCoreMinimization(int mode, int budget, double fraction) {
+    core_minimization = mode;
+    core_budget = budget;
+    core_time_fraction = fraction;
+  }
   bool getPrint() { return print; }
 
   void setPrintSoft(const char* file) { 
@@ -236,6 +283,26 @@ protected:
 
   void reserveSATVariables(Solver *S, unsigned maxVariable); // Reserve space for multiple variables in the SAT solver.
 
+  // Improves the model of 'S' by local search, updating 'model', 'ubCost'
+  // and the phases of 'S'.
+  bool improveModel(Solver *S);
+
+  // Bound-based hardening (see 'hardenSoftClauses').
+  bool canHarden(uint64_t weight, uint64_t lb);
+  void hardenSoftClauses(Solver *S, uint64_t lb, vec<Lit> &units,
+                         vec<bool> *relaxed = NULL);
+  void addHardened(Solver *S); // Adds the hardened soft clauses to 'S'.
+  // Adds 'assumps' to 'S' once the optimum of a weight level is found.
+  void hardenLevel(Solver *S, vec<Lit> &assumps);
+  bool isHardened(int soft) {
+    return soft >= 0 && soft < hardened.size() && hardened[soft];
+  }
+
+  // Shrinks a core of 'S' by trimming and destructive minimization.
+  void minimizeCore(Solver *S, vec<Lit> &core);
+  bool trimCore(Solver *S, vec<Lit> &core, double limit);
+  void destructiveMinimization(Solver *S, vec<Lit> &core, double limit);
+
   // Properties of the MaxSAT formula
   //
   vec<lbool> model; // Stores the best satisfying model.
@@ -247,6 +314,7 @@ protected:
   int nbSymmetryClauses; // Number of symmetry clauses.
   uint64_t sumSizeCores; // Sum of the sizes of cores.
   int nbSatisfiable;     // Number of satisfiable calls.
+  uint64_t nbMinimizedLits; // Literals removed by core minimization.
 
   // Bound values
   //
@@ -256,6 +324,28 @@ protected:
 
   MaxSATFormula *maxsat_formula;
 
+  // Mapping between assumption literals and soft clauses
+  //
+  // Indexed by the variable of the assumption literal. Filled when the
+  // assumption literals are created (see 'initRelaxation' and
+  // 'initAssumptions' of each algorithm) and used to map cores back to soft
+  // clauses.
+  vec<int> coreMapping; // Soft clause of each variable (-1 if none).
+
+  void clearCoreMapping() { coreMapping.clear(); }
+  void setCoreMapping(Lit p, int soft) {
+    coreMapping.growTo(var(p) + 1, -1);
+    coreMapping[var(p)] = soft;
+  }
+  void unsetCoreMapping(Lit p) {
+    if (var(p) < coreMapping.size())
+      coreMapping[var(p)] = -1;
+  }
+  // Soft clause of assumption literal 'p' (-1 if none).
+  int softIndex(Lit p) {
+    return var(p) < coreMapping.size() ? coreMapping[var(p)] : -1;
+  }
+
   // Others
   // int currentWeight;  // Initialized to the maximum weight of soft clauses.
   double initialTime; // Initial time.
@@ -264,6 +354,28 @@ protected:
   bool print;         // Controls if data should be printed at all
   bool print_soft;    // Controls if the unsatified soft clauses are printed at the end.
   bool print_json = false;
+  int partition_order = _ORDER_SIZE_;
+  Portfolio *portfolio = NULL;
+  int portfolio_id = -1;
+  std::mutex search_lock; // Protects 'running' and 'interrupted'.
+  Solver *running = NULL; // Solver of the current SAT call.
+  bool interrupted = false;
+  bool solution_phases = false;
+  uint64_t nbModels = 0;         // Number of calls to 'saveModel'.
+  Solver *phased_solver = NULL;  // Last solver that got the best model as
+  uint64_t phased_models = 0;    // phases, and 'nbModels' at that time.
+  ConflictBudget conflict_budget; // Of the SAT calls on partitions.
+  bool hardening = false;
+  vec<bool> hardened;                // Soft clauses hardened so far.
+  uint64_t hardened_gap = UINT64_MAX; // Gap of the last hardening.
+  int nbHardened = 0;
+  bool bmo_search = false;
+  LocalSearch *local_search = NULL;
+  uint64_t ls_flips = 0; // Flips of each local search (0=none).
+  int core_minimization = _CORE_MIN_NONE_;
+  int core_budget = 1000;          // Conflicts of each minimization call.
+  double core_time_fraction = 0.1; // Of the elapsed time, for each core.
+  vec<bool> coreSeen;              // Marks core literals (by variable).
   char * unsat_soft_file;  // Name of the file where the unsatisfied soft clauses will be printed
 
   // Different weights that corresponds to each function in the BMO algorithm.
@@ -26,6 +26,7 @@
  *
  */
 
+#include <algorithm>
 #include <iostream>
 
 #include "MaxSATFormula.h"
@@ -33,7 +34,7 @@
 using namespace upmax;
 
 MaxSATFormula *MaxSATFormula::copyMaxSATFormula() {
-  assert(format == _FORMAT_MAXSAT_);
+  assert(format == _FORMAT_MAXSAT_ || format == _FORMAT_PWCNF_);
 
   MaxSATFormula *copymx = new MaxSATFormula();
   copymx->setInitialVars(nVars());
@@ -41,16 +42,22 @@ MaxSATFormula *MaxSATFormula::copyMaxSATFormula() {
   for (int i = 0; i < nVars(); i++)
     copymx->newVar();
 
-  for (int i = 0; i < nSoft(); i++)
+  for (int i = 0; i < nSoft(); i++) {
     copymx->addSoftClause(getSoftClause(i).weight, getSoftClause(i).clause);
+    copymx->setSoftClausePartition(getSoftClause(i).getPartition());
+  }
 
-  for (int i = 0; i < nHard(); i++)
+  for (int i = 0; i < nHard(); i++) {
     copymx->addHardClause(getHardClause(i).clause);
+    copymx->setHardClausePartition(getHardClause(i).getPartition());
+  }
 
   copymx->setProblemType(getProblemType());
   copymx->updateSumWeights(getSumWeights());
   copymx->setMaximumWeight(getMaximumWeight());
   copymx->setHardWeight(getHardWeight());
+  copymx->setPartitions(nPartitions());
+  copymx->setFormat(getFormat());
 
   return copymx;
 }
@@ -140,6 +147,28 @@ int MaxSATFormula::getProblemType() {
   return problem_type; // Return the problem type.
 }
 
+bool MaxSATFormula::isBMO(std::vector<uint64_t> &weights) {
+  std::map<uint64_t, uint64_t> nbWeights;
+  for (int i = 0; i < nSoft(); i++)
+    nbWeights[getSoftClause(i).weight]++;
+
+  weights.clear();
+  uint64_t totalWeights = 0;
+  for (std::map<uint64_t, uint64_t>::iterator it = nbWeights.begin();
+       it != nbWeights.end(); ++it) {
+    weights.push_back(it->first);
+    totalWeights += it->first * it->second;
+  }
+  std::reverse(weights.begin(), weights.end());
+
+  for (int i = 0; i < (int)weights.size(); i++) {
+    totalWeights -= weights[i] * nbWeights[weights[i]];
+    if (weights[i] < totalWeights)
+      return false;
+  }
+  return true;
+}
+
 // 'ubCost' is initialized to the sum of weights of the soft clauses.
 void MaxSATFormula::updateSumWeights(uint64_t weight) {
   if (weight != hard_weight)
@@ -40,6 +40,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 using NSPACE::vec;
 using NSPACE::Lit;
@@ -101,7 +102,7 @@ public:
   MaxSATFormula()
       : hard_weight(UINT64_MAX), problem_type(_UNWEIGHTED_), n_vars(0),
         n_soft(0), n_hard(0), n_initial_vars(0), sum_soft_weight(0),
-        max_soft_weight(0) {
+        max_soft_weight(0), n_partitions(0) {
     objective_function = NULL;
     format = _FORMAT_MAXSAT_;
   }
@@ -142,6 +143,10 @@ public:
   void setProblemType(int type); // Set problem type.
   int getProblemType();          // Get problem type.
 
+  // Tests if each weight of the soft clauses is greater than the sum of all
+  // lighter soft clauses. 'weights' gets the distinct weights, heaviest first.
+  bool isBMO(std::vector<uint64_t> &weights);
+
   void updateSumWeights(uint64_t weight); // Update initial 'ubCost'.
   uint64_t getSumWeights() { return sum_soft_weight; }
 
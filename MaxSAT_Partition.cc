@@ -31,17 +31,25 @@
 #include "MaxSAT_Partition.h"
 #include "graph/Graph.h"
 #include "graph/Graph_Communities.h"
+#include "graph/Hypergraph.h"
 
 using namespace upmax;
 
 #define _EDGE_LIMIT_ 50000000
+// Clauses with more unassigned variables are not hyperedges. Moving a vertex
+// between communities visits all pins of its hyperedges, so such clauses
+// would make each pass quadratic in their size.
+#define _HYPEREDGE_LIMIT_ 1000
 
 MaxSAT_Partition::MaxSAT_Partition(char * file) {
   _solver = NULL;
 
   _nRandomPartitions = 16;
+  _nBalancedPartitions = 16;
+  _imbalance = 0.05;
   _nPartitions = 0;
   _randomSeed = 0;
+  _seed = 0;
 
   _graph = NULL;
 
@@ -54,12 +62,10 @@ MaxSAT_Partition::~MaxSAT_Partition() {
 }
 
 void MaxSAT_Partition::init() {
-  static bool executed = false;
-
-  if (!executed) {
-    srand(_randomSeed);
-    executed = true;
-  }
+  // Each formula is split with its own random generator, such that it gets
+  // the same partitions whether it is split alone or by a batch worker.
+  _seed = _randomSeed;
+  _gc.setRandomSeed(_randomSeed);
 
   if (_graph != NULL)
     delete _graph;
@@ -91,24 +97,42 @@ void MaxSAT_Partition::split(int mode, int graphType) {
 
   if (!_solver->okay()) {
     delete _solver;
+    _solver = NULL;
     return;
   }
 
-  if (mode == PWCNF_MODE)
+  // Stream partitions are assigned while parsing and stored as in pwcnf files
+  if (mode == PWCNF_MODE || mode == STREAM_MODE)
     splitPWCNF();
   else if (mode == RAND_MODE)
     splitRandom();
-  else {
+  else if (graphType == HYPER_GRAPH) {
+    // Hypergraphs are only split with the unfolding method
+    Hypergraph *h = buildHypergraph();
+    _gc.findHypergraphCommunities(h);
+    delete h;
+
+    buildPartitions(graphType);
+  } else {
     _graph = buildGraph(true, graphType);
 
     if (_graph == NULL) {
       // Graph was not built because of the edge limit...
-      buildSinglePartition();
+      if (maxsat_formula->nPartitions() > 0)
+        splitPWCNF();
+      else
+        buildSinglePartition();
     } else {
       // printf("c Graph: #V: %d\t#E: %d\n", _graph->nVertexes(),
       // _graph->nEdges());
 
-      _gc.findCommunities(mode, _graph);
+      if (mode == MULTILEVEL_MODE) {
+        vec<double> weights;
+        softVertexWeights(graphType, weights);
+        _gc.findBalancedCommunities(_graph, weights, _nBalancedPartitions,
+                                    _imbalance);
+      } else
+        _gc.findCommunities(mode, _graph);
       // printf("c %d Communities found\n", _gc.nCommunities());
 
       buildPartitions(graphType);
@@ -116,22 +140,34 @@ void MaxSAT_Partition::split(int mode, int graphType) {
   }
 
   delete _solver;
+  _solver = NULL;
 }
 
 void MaxSAT_Partition::splitPWCNF() {
-    _nPartitions = maxsat_formula->nPartitions();
-  _partitions.growTo(_nPartitions);
+  _nPartitions = maxsat_formula->nPartitions();
+  // Partitions in pwcnf files are numbered from 1
+  _partitions.growTo(_nPartitions + 1);
 
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
     // Satisfied or unsatisfied clauses are not assigned a community
-    if (!unassignedLiterals(maxsat_formula->getSoftClause(i).clause))
+    int c = maxsat_formula->getSoftClause(i).getPartition();
+    if (c < 0 || !unassignedLiterals(maxsat_formula->getSoftClause(i).clause))
       _graphMappingSoft[i] = -1;
     else {
-      int c = maxsat_formula->getSoftClause(i).getPartition();
       _partitions[c].sclauses.push(i);
       _graphMappingSoft[i] = c;
     }
   }
+
+  for (int i = 0; i < maxsat_formula->nHard(); i++) {
+    int c = maxsat_formula->getHardClause(i).getPartition();
+    if (c < 0 || !unassignedLiterals(maxsat_formula->getHardClause(i).clause))
+      _graphMappingHard[i] = -1;
+    else {
+      _partitions[c].hclauses.push(i);
+      _graphMappingHard[i] = c;
+    }
+  }
 }
 
 void MaxSAT_Partition::splitRandom() {
@@ -143,7 +179,7 @@ void MaxSAT_Partition::splitRandom() {
     if (!unassignedLiterals(maxsat_formula->getSoftClause(i).clause))
       _graphMappingSoft[i] = -1;
     else {
-      int c = rand() % _nPartitions;
+      int c = rand_r(&_seed) % _nPartitions;
       _partitions[c].sclauses.push(i);
       _graphMappingSoft[i] = c;
     }
@@ -182,7 +218,7 @@ void MaxSAT_Partition::buildPartitions(int graphType) {
   _nPartitions = _gc.nCommunities();
   _partitions.growTo(_nPartitions);
 
-  if (graphType == VIG_GRAPH)
+  if (graphType == VIG_GRAPH || graphType == HYPER_GRAPH)
     buildVIGPartitions();
   else if (graphType == CVIG_GRAPH)
     buildCVIGPartitions();
@@ -338,6 +374,85 @@ void MaxSAT_Partition::buildRESPartitions() {
   }
 }
 
+// Each unresolved clause is a hyperedge over its unassigned variables (see
+// _HYPEREDGE_LIMIT_). Pairs of variables get the same weight as in the
+// weighted VIG graph.
+Hypergraph *MaxSAT_Partition::buildHypergraph() {
+  int gVars = 0;
+
+  for (int i = 0; i < maxsat_formula->nVars(); i++) {
+    if (_solver->value(i) != l_Undef)
+      _graphMappingVar[i] = -1;
+    else
+      _graphMappingVar[i] = gVars++;
+  }
+
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    _graphMappingSoft[i] = -1;
+  for (int i = 0; i < maxsat_formula->nHard(); i++)
+    _graphMappingHard[i] = -1;
+
+  Hypergraph *h = new Hypergraph(gVars);
+  vec<bool> marked;
+  marked.growTo(gVars, false);
+
+  for (int ci = 0; ci < maxsat_formula->nHard(); ci++)
+    addClauseHyperedge(h, maxsat_formula->getHardClause(ci).clause, marked);
+
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    addClauseHyperedge(h, maxsat_formula->getSoftClause(i).clause, marked);
+
+  h->buildIncidence();
+  return h;
+}
+
+void MaxSAT_Partition::addClauseHyperedge(Hypergraph *h, vec<Lit> &c,
+                                          vec<bool> &marked) {
+  if (unassignedLiterals(c) == 0)
+    return;
+
+  vec<int> pins;
+  for (int i = 0; i < c.size(); i++) {
+    if (_solver->value(c[i]) != l_Undef)
+      continue;
+    int u = _graphMappingVar[var(c[i])];
+    if (!marked[u]) {
+      marked[u] = true;
+      pins.push(u);
+    }
+  }
+
+  for (int i = 0; i < pins.size(); i++)
+    marked[pins[i]] = false;
+
+  int ul = pins.size();
+  if (ul > 1 && ul <= _HYPEREDGE_LIMIT_)
+    h->addEdge(pins, 2.0 / (ul * (ul - 1)));
+}
+
+// Weight of each graph vertex is the number of unresolved soft clauses it
+// accounts for. With the VIG graph, soft clauses are later assigned to the
+// partition of their variables, hence each variable gets a share of the
+// clause.
+void MaxSAT_Partition::softVertexWeights(int graphType, vec<double> &weights) {
+  weights.clear();
+  weights.growTo(_graph->nVertexes(), 0.0);
+
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    vec<Lit> &c = maxsat_formula->getSoftClause(i).clause;
+    int ul = unassignedLiterals(c);
+    if (ul == 0)
+      continue;
+
+    if (graphType == VIG_GRAPH) {
+      for (int j = 0; j < c.size(); j++)
+        if (_solver->value(c[j]) == l_Undef)
+          weights[_graphMappingVar[var(c[j])]] += 1.0 / ul;
+    } else
+      weights[_graphMappingSoft[i]] += 1.0;
+  }
+}
+
 Graph *MaxSAT_Partition::buildGraph(bool weighted, int graphType) {
   if (graphType == VIG_GRAPH)
     return buildVIGGraph(weighted);
@@ -523,7 +638,8 @@ Graph *MaxSAT_Partition::buildCVIGGraph(bool weighted) {
       }
 
       if (nEdges >= _EDGE_LIMIT_) {
-        printf("c Graph is too large.\n");
+        if (print)
+          printf("c Graph is too large.\n");
         delete[] graphWeight;
         delete g;
         return NULL;
@@ -551,7 +667,8 @@ Graph *MaxSAT_Partition::buildCVIGGraph(bool weighted) {
       }
 
       if (nEdges >= _EDGE_LIMIT_) {
-        printf("c Graph is too large.\n");
+        if (print)
+          printf("c Graph is too large.\n");
         delete[] graphWeight;
         delete g;
         return NULL;
@@ -677,7 +794,8 @@ Graph *MaxSAT_Partition::buildRESGraph(bool weighted) {
 
         // printf("%d Edges\n", nEdges);
         if (nEdges >= _EDGE_LIMIT_) {
-          printf("c Graph is too large.\n");
+          if (print)
+            printf("c Graph is too large.\n");
           for (int i = 0; i < nLits; i++)
             litClauses[i].clear();
           delete[] litClauses;
@@ -737,7 +855,8 @@ Graph *MaxSAT_Partition::buildRESGraph(bool weighted) {
           }
         }
         if (nEdges >= _EDGE_LIMIT_) {
-          printf("c Graph is too large.\n");
+          if (print)
+            printf("c Graph is too large.\n");
           for (int i = 0; i < nLits; i++)
             litClauses[i].clear();
           delete[] litClauses;
@@ -763,3 +882,63 @@ Graph *MaxSAT_Partition::buildRESGraph(bool weighted) {
   delete[] graphWeight;
   return g;
 }
+
+/*_________________________________________________________________________________________________
+  |
+  |  extractPartitionCores : (solvers : vec<Solver *>&)
+  |                          (partitions : vec<vec<int>>&) (limit : int)
+  |                          ->  [StatusCode]
+  |
+  |  Description:
+  |
+  |    Extracts disjoint cores of each partition before the search, with one
+  |    worker for each SAT solver in 'solvers' (see 'PartitionCores'), where
+  |    'partitions' holds the soft clauses of each partition. Since
+  |    the cores are disjoint, the algorithms can relax all of them at once
+  |    when their partition is added to the formula, instead of finding them
+  |    one SAT call at a time. 'limit' is the conflict limit for each
+  |    partition (-1 if none).
+  |
+  |  Post-conditions:
+  |    * 'partitionCores' holds the cores of each partition.
+  |    * The solvers are deleted.
+  |    * Returns _UNKNOWN_ unless the hard clauses are unsatisfiable.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode MaxSAT_Partition::extractPartitionCores(vec<Solver *> &solvers,
+                                                   vec<vec<int>> &partitions,
+                                                   int limit) {
+  PartitionCores extractor(maxsat_formula, limit);
+  extractor.extract(solvers, partitions);
+
+  int nbSolvers = solvers.size();
+  for (int i = 0; i < solvers.size(); i++)
+    delete solvers[i];
+  solvers.clear();
+
+  if (extractor.isUnsat()) {
+    printAnswer(_UNSATISFIABLE_);
+    return _UNSATISFIABLE_;
+  }
+
+  if (extractor.model().size() > 0) {
+    nbSatisfiable++;
+    if (extractor.cost() <= ubCost) {
+      saveModel(extractor.model());
+      printBound(extractor.cost());
+      ubCost = extractor.cost();
+    }
+  }
+
+  partitionCores.growTo(partitions.size());
+  for (int i = 0; i < extractor.nCores(); i++) {
+    vec<vec<int>> &cores = partitionCores[extractor.corePartition(i)];
+    cores.push();
+    extractor.core(i).copyTo(cores.last());
+  }
+
+  if (print)
+    printf("c Partition cores = %d (%d threads)\n", extractor.nCores(),
+           nbSolvers);
+  return _UNKNOWN_;
+}
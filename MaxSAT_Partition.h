@@ -30,9 +30,11 @@
 #define MAXSAT_PARTITION_H
 
 #include "MaxSAT.h"
+#include "PartitionCores.h"
 
 #include "graph/Graph.h"
 #include "graph/Graph_Communities.h"
+#include "graph/Hypergraph.h"
 
 #include <iostream>
 #include <fstream> 
@@ -43,7 +45,13 @@ using NSPACE::Var;
 
 namespace upmax {
 
-enum graphType_ { VIG_GRAPH = 0, CVIG_GRAPH = 1, RES_GRAPH = 2 };
+// Graph type 3 stands for random splits.
+enum graphType_ {
+  VIG_GRAPH = 0,
+  CVIG_GRAPH = 1,
+  RES_GRAPH = 2,
+  HYPER_GRAPH = 4
+};
 
 typedef struct {
   vec<int> vars;
@@ -64,6 +72,12 @@ public:
   void setRandomPartitions(int n) { _nRandomPartitions = n; }
   int getRandomPartitions() { return _nRandomPartitions; }
 
+  // Set number of partitions and allowed imbalance of the balanced split
+  void setBalancedPartitions(int n) { _nBalancedPartitions = n; }
+  int getBalancedPartitions() { return _nBalancedPartitions; }
+  void setImbalance(double imbalance) { _imbalance = imbalance; }
+  double getImbalance() { return _imbalance; }
+
   // Set random seed
   void setRandomSeed(int n) { _randomSeed = n; }
   int getRandomSeed() { return _randomSeed; }
@@ -193,6 +207,12 @@ void printPWCNFtoFile(std::string filename, bool wcnf = false) {
   void init();
 
 protected:
+  // Disjoint cores of each partition, found before the search with one
+  // worker for each solver in 'solvers' (which are deleted afterwards).
+  StatusCode extractPartitionCores(vec<Solver *> &solvers,
+                                   vec<vec<int>> &partitions, int limit);
+  vec<vec<vec<int>>> partitionCores; // Soft clauses of the cores of each
+                                     // partition.
 
   void splitRandom();
 
@@ -207,6 +227,11 @@ protected:
   Graph *buildCVIGGraph(bool weighted);
   Graph *buildRESGraph(bool weighted);
 
+  Hypergraph *buildHypergraph();
+  void addClauseHyperedge(Hypergraph *h, vec<Lit> &c, vec<bool> &marked);
+
+  void softVertexWeights(int graphType, vec<double> &weights);
+
   int unassignedLiterals(vec<Lit> &sc);
   bool isUnsatisfied(vec<Lit> &sc);
 
@@ -223,7 +248,10 @@ protected:
   vec<int> _graphMappingSoft;
 
   int _randomSeed;
+  unsigned int _seed; // State of the random generator (see 'init').
   int _nRandomPartitions;
+  int _nBalancedPartitions;
+  double _imbalance;
   int _nPartitions;
   vec<Partition> _partitions;
 
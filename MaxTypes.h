@@ -47,6 +47,9 @@ public:
   const char* getMsg() const {return s.str().c_str();}
 };
 
+// Thrown by the SAT calls of a solver that is stopped by the portfolio.
+class InterruptException {};
+
 enum { _FORMAT_MAXSAT_ = 0, _FORMAT_PB_ = 1, _FORMAT_PWCNF_ = 3 };
 enum { _VERBOSITY_MINIMAL_ = 0, _VERBOSITY_SOME_ };
 enum { _UNWEIGHTED_ = 0, _WEIGHTED_ };
@@ -55,6 +58,7 @@ enum {
   _ALGORITHM_WBO_ = 0,
   _ALGORITHM_MSU3_,
   _ALGORITHM_OLL_,
+  _ALGORITHM_LNS_, // Only used next to other algorithms (see 'Portfolio').
 };
 enum StatusCode {
   _SATISFIABLE_ = 10,
@@ -70,6 +74,9 @@ enum {
   _INCREMENTAL_ITERATIVE_
 };
 enum { _SIZE_, _CORES_, _SATURATION_ONLY_ };
+enum { _ORDER_SIZE_ = 0, _ORDER_WEIGHT_, _ORDER_ADJACENCY_, _ORDER_CORES_ };
+enum { _CORE_MIN_NONE_ = 0, _CORE_MIN_TRIM_, _CORE_MIN_DESTRUCTIVE_ };
+enum { _STRAT_NONE_ = 0, _STRAT_PARTITION_, _STRAT_WEIGHT_ };
 enum { _CARD_CNETWORKS_ = 0, _CARD_TOTALIZER_, _CARD_MTOTALIZER_ };
 enum { _AMO_LADDER_ = 0 };
 enum { _PB_SWC_ = 0, _PB_GTE_, _PB_ADDER_ };
@@ -35,6 +35,7 @@
 
 #include "MaxSATFormula.h"
 #include "core/SolverTypes.h"
+#include "graph/Stream_Partitioner.h"
 #include "utils/ParseUtils.h"
 
 #ifdef HAS_EXTRA_STREAMBUFFER
@@ -82,8 +83,11 @@ static uint64_t readClause(B &in, MaxSATFormula *maxsat_formula,
   return weight;
 }
 
+// If a stream partitioner is given, each clause is assigned a partition as
+// soon as it is read.
 template <class B, class MaxSATFormula>
-static void parseMaxSAT(B &in, MaxSATFormula *maxsat_formula) {
+static void parseMaxSAT(B &in, MaxSATFormula *maxsat_formula,
+                        Stream_Partitioner *stream = NULL) {
   vec<Lit> lits;
   uint64_t hard_weight = UINT64_MAX;
   for (;;) {
@@ -93,11 +97,15 @@ static void parseMaxSAT(B &in, MaxSATFormula *maxsat_formula) {
     else if (*in == 'p') {
       if (eagerMatch(in, "p cnf")) {
         parseInt(in); // Variables
-        parseInt(in); // Clauses
+        int clauses = parseInt(in);
+        if (stream != NULL)
+          stream->setExpectedClauses(clauses);
       } else if (eagerMatch(in, "wcnf")) {
         maxsat_formula->setProblemType(_WEIGHTED_);
         parseInt(in); // Variables
-        parseInt(in); // Clauses
+        int clauses = parseInt(in);
+        if (stream != NULL)
+          stream->setExpectedClauses(clauses);
         if (*in != '\r' && *in != '\n') {
           hard_weight = parseWeight(in);
           maxsat_formula->setHardWeight(hard_weight);
@@ -117,19 +125,28 @@ static void parseMaxSAT(B &in, MaxSATFormula *maxsat_formula) {
         // Updates the sum of the weights of soft clauses.
         maxsat_formula->updateSumWeights(weight);
         maxsat_formula->addSoftClause(weight, lits);
-      } else
+        if (stream != NULL)
+          maxsat_formula->setSoftClausePartition(stream->assign(lits));
+      } else {
         maxsat_formula->addHardClause(lits);
+        if (stream != NULL)
+          maxsat_formula->setHardClausePartition(stream->assign(lits));
+      }
     }
   }
+
+  if (stream != NULL)
+    maxsat_formula->setPartitions(stream->nPartitions());
 }
 
 // Inserts problem into solver.
 //
 template <class MaxSATFormula>
 static void parseMaxSATFormula(gzFile input_stream,
-                               MaxSATFormula *maxsat_formula) {
+                               MaxSATFormula *maxsat_formula,
+                               Stream_Partitioner *stream = NULL) {
   StreamBuffer in(input_stream);
-  parseMaxSAT(in, maxsat_formula);
+  parseMaxSAT(in, maxsat_formula, stream);
   if (maxsat_formula->getMaximumWeight() == 1)
     maxsat_formula->setProblemType(_UNWEIGHTED_);
   else
@@ -132,7 +132,7 @@ int ParserPB::parseLine() {
 
 int ParserPB::parseCostFunction() {
   // int objective = _PB_MIN_;
-  static char word[MAX_WORD_LENGTH];
+  char *word = _word;
   int i;
 
   // printf("c Parsing objective function...\n");
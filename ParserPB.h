@@ -99,13 +99,13 @@ protected:
   }
 
   inline void readUntilEndOfLine() {
-    static char c;
+    char c;
     while ((c = get_char()) != '\n' && c != '\0')
       ;
   }
 
   inline void parseNumber(int64_t *coeff) {
-    static char word[MAX_WORD_LENGTH];
+    char *word = _word;
     int i = 0, c = peek_char();
     int64_t conv;
 
@@ -151,6 +151,10 @@ protected:
   char *_fileStr;
   int _fd;
 
+  // Buffer of the words that are not variable names. It is not static such
+  // that formulas can be parsed in parallel.
+  char _word[MAX_WORD_LENGTH];
+
   vec<int64_t> _coefficients;
   vec<int> _constraintVariables;
 
@@ -0,0 +1,162 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "PartitionCores.h"
+
+#include <thread>
+#include <vector>
+
+using namespace upmax;
+
+/*_________________________________________________________________________________________________
+  |
+  |  extract : (solvers : vec<Solver *>&) (partitions : vec<vec<int>>&)
+  |            ->  [void]
+  |
+  |  Description:
+  |
+  |    Runs one worker thread for each SAT solver in 'solvers'. Each worker
+  |    extracts disjoint cores of a partition until the remaining soft clauses
+  |    of that partition are satisfiable, and then takes the next partition.
+  |
+  |  Post-conditions:
+  |    * The cores found by the workers are available through 'core'.
+  |    * The best model found when a partition became satisfiable is
+  |      available through 'model'.
+  |
+  |________________________________________________________________________________________________@*/
+void PartitionCores::extract(vec<Solver *> &solvers,
+                             vec<vec<int>> &partitions) {
+  _softIndex.clear();
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    Var v = var(maxsat_formula->getSoftClause(i).assumption_var);
+    _softIndex.growTo(v + 1, -1);
+    _softIndex[v] = i;
+  }
+
+  _next = 0;
+  std::vector<std::thread> pool;
+  for (int i = 0; i < solvers.size(); i++)
+    pool.push_back(
+        std::thread([this, &solvers, &partitions, i]() {
+          worker(solvers[i], partitions);
+        }));
+  for (size_t i = 0; i < pool.size(); i++)
+    pool[i].join();
+}
+
+void PartitionCores::worker(Solver *S, vec<vec<int>> &partitions) {
+  vec<bool> inCore(maxsat_formula->nSoft(), false);
+  for (;;) {
+    int p = _next++;
+    if (p >= partitions.size() || _unsat)
+      return;
+    extractPartition(S, partitions, p, inCore);
+  }
+}
+
+// Disjoint cores of the soft clauses of partition 'p'.
+void PartitionCores::extractPartition(Solver *S, vec<vec<int>> &partitions,
+                                      int p, vec<bool> &inCore) {
+  vec<int> &softs = partitions[p];
+  vec<Lit> assumptions;
+  for (int i = 0; i < softs.size(); i++)
+    assumptions.push(~maxsat_formula->getSoftClause(softs[i]).assumption_var);
+
+  vec<Lit> remaining;
+  vec<int> core;
+  for (;;) {
+    if (_limit != -1)
+      S->setConfBudget(_limit);
+    else
+      S->budgetOff();
+
+#ifdef SIMP
+    lbool res = ((NSPACE::SimpSolver *)S)->solveLimited(assumptions, false);
+#else
+    lbool res = S->solveLimited(assumptions);
+#endif
+
+    if (res == l_Undef)
+      return;
+
+    if (res == l_True) {
+      uint64_t cost = computeCost(S->model);
+      std::lock_guard<std::mutex> guard(_lock);
+      if (cost < _cost) {
+        _cost = cost;
+        S->model.copyTo(_model);
+      }
+      return;
+    }
+
+    if (S->conflict.size() == 0) {
+      _unsat = true;
+      return;
+    }
+
+    // The soft clauses of the core are no longer assumed.
+    core.clear();
+    for (int i = 0; i < S->conflict.size(); i++) {
+      Var v = var(S->conflict[i]);
+      assert(v < _softIndex.size() && _softIndex[v] != -1);
+      core.push(_softIndex[v]);
+      inCore[_softIndex[v]] = true;
+    }
+
+    remaining.clear();
+    for (int i = 0; i < assumptions.size(); i++)
+      if (!inCore[_softIndex[var(assumptions[i])]])
+        remaining.push(assumptions[i]);
+    remaining.copyTo(assumptions);
+    for (int i = 0; i < core.size(); i++)
+      inCore[core[i]] = false;
+
+    std::lock_guard<std::mutex> guard(_lock);
+    _cores.push();
+    core.copyTo(_cores.last());
+    _corePartition.push(p);
+  }
+}
+
+// Sum of the weights of the soft clauses falsified by 'model'.
+uint64_t PartitionCores::computeCost(vec<lbool> &model) {
+  uint64_t cost = 0;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    Soft &s = maxsat_formula->getSoftClause(i);
+    bool satisfied = false;
+    for (int j = 0; j < s.clause.size() && !satisfied; j++) {
+      Lit l = s.clause[j];
+      satisfied = (sign(l) && model[var(l)] == l_False) ||
+                  (!sign(l) && model[var(l)] == l_True);
+    }
+    if (!satisfied)
+      cost += s.weight;
+  }
+  return cost;
+}
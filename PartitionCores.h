@@ -0,0 +1,98 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef PARTITION_CORES_H
+#define PARTITION_CORES_H
+
+#ifdef SIMP
+#include "simp/SimpSolver.h"
+#else
+#include "core/Solver.h"
+#endif
+
+#include "MaxSATFormula.h"
+
+#include <atomic>
+#include <mutex>
+
+using NSPACE::Solver;
+using NSPACE::Var;
+using NSPACE::lbool;
+using NSPACE::vec;
+
+namespace upmax {
+
+// Extracts disjoint cores of each partition in parallel. Each worker owns a
+// SAT solver with all hard clauses and takes partitions one at a time,
+// assuming only the soft clauses of that partition. Since partitions do not
+// share soft clauses, the cores of all partitions are disjoint and each one
+// increases the lower bound of unweighted formulas by one.
+class PartitionCores {
+
+public:
+  PartitionCores(MaxSATFormula *mx, int limit = -1)
+      : maxsat_formula(mx), _limit(limit), _unsat(false),
+        _cost(UINT64_MAX) {}
+
+  // 'solvers' holds one SAT solver for each worker with the hard and the
+  // relaxed soft clauses of the formula.
+  void extract(vec<Solver *> &solvers, vec<vec<int>> &partitions);
+
+  // Valid after extract is called.
+  int nCores() { return _cores.size(); }
+  const vec<int> &core(int i) { return _cores[i]; } // Soft clauses.
+  int corePartition(int i) { return _corePartition[i]; }
+  bool isUnsat() { return _unsat; } // Hard clauses are unsatisfiable.
+
+  // Best model found by the workers (empty if none).
+  vec<lbool> &model() { return _model; }
+  uint64_t cost() { return _cost; }
+
+protected:
+  void worker(Solver *S, vec<vec<int>> &partitions);
+  void extractPartition(Solver *S, vec<vec<int>> &partitions, int p,
+                        vec<bool> &inCore);
+  uint64_t computeCost(vec<lbool> &model);
+
+  MaxSATFormula *maxsat_formula;
+  int _limit; // Conflict limit for each partition (-1 if none).
+
+  vec<int> _softIndex; // Soft clause of each assumption variable.
+
+  std::mutex _lock;       // Protects the results below.
+  std::atomic<int> _next; // Next partition to be taken by a worker.
+  std::atomic<bool> _unsat;
+  vec<vec<int>> _cores;
+  vec<int> _corePartition; // Index in 'partitions' of each core.
+  vec<lbool> _model;
+  uint64_t _cost;
+};
+
+} // namespace upmax
+
+#endif // PARTITION_CORES_H
@@ -0,0 +1,331 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#include "PartitionSchedule.h"
+#include "mtl/Sort.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace upmax;
+
+// Variables that occur in more partitions are connected as a chain.
+#define MAX_CLIQUE_PARTITIONS 64
+
+/*_________________________________________________________________________________________________
+  |
+  |  build : (partitions : vec<vec<int>>&) ->  [void]
+  |
+  |  Description:
+  |
+  |    Groups the soft clauses by partition and stores the non-empty
+  |    partitions in 'partitions', sorted by the selected ordering:
+  |      * _ORDER_SIZE_: fewer soft clauses first;
+  |      * _ORDER_WEIGHT_: larger total weight first;
+  |      * _ORDER_ADJACENCY_: breadth-first over the partitions that share
+  |        variables, such that related partitions are consecutive;
+  |      * _ORDER_CORES_: higher estimate of core density first.
+  |
+  |  Pre-conditions:
+  |    * Partitions are numbered from 1 to nPartitions(). Soft clauses without
+  |      a valid partition are grouped in an extra partition.
+  |
+  |________________________________________________________________________________________________@*/
+void PartitionSchedule::build(vec<vec<int>> &partitions) {
+  int n = maxsat_formula->nPartitions() + 2;
+
+  _soft.clear();
+  _soft.growTo(n);
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    int p = maxsat_formula->getSoftClause(i).getPartition();
+    if (p < 0 || p > maxsat_formula->nPartitions())
+      p = n - 1;
+    _soft[p].push(i);
+  }
+
+  _nonEmpty.clear();
+  for (int p = 0; p < n; p++)
+    if (_soft[p].size() > 0)
+      _nonEmpty.push(p);
+
+  vec<int> order;
+  switch (_order) {
+  case _ORDER_WEIGHT_:
+    orderByWeight(order);
+    break;
+  case _ORDER_ADJACENCY_:
+    orderByAdjacency(order);
+    break;
+  case _ORDER_CORES_:
+    orderByCores(order);
+    break;
+  default:
+    orderBySize(order);
+  }
+  assert(order.size() == _nonEmpty.size());
+
+  partitions.clear();
+  for (int i = 0; i < order.size(); i++) {
+    partitions.push();
+    _soft[order[i]].moveTo(partitions.last());
+  }
+  _soft.clear();
+}
+
+void PartitionSchedule::buildLevel(const vec<vec<int>> &partitions,
+                                   uint64_t weight, vec<vec<int>> &level) {
+  level.clear();
+  for (int k = 0; k < partitions.size(); k++) {
+    level.push();
+    for (int i = 0; i < partitions[k].size(); i++)
+      if (maxsat_formula->getSoftClause(partitions[k][i]).weight == weight)
+        level.last().push(partitions[k][i]);
+    if (level.last().size() == 0)
+      level.pop();
+  }
+}
+
+void PartitionSchedule::orderBySize(vec<int> &order) {
+  std::vector<std::pair<int, int>> v;
+  for (int i = 0; i < _nonEmpty.size(); i++)
+    v.push_back(std::make_pair(_soft[_nonEmpty[i]].size(), _nonEmpty[i]));
+
+  std::sort(v.begin(), v.end());
+  for (size_t i = 0; i < v.size(); i++)
+    order.push(v[i].second);
+}
+
+void PartitionSchedule::orderByWeight(vec<int> &order) {
+  std::vector<std::pair<uint64_t, int>> v;
+  for (int i = 0; i < _nonEmpty.size(); i++) {
+    uint64_t w = 0;
+    vec<int> &soft = _soft[_nonEmpty[i]];
+    for (int j = 0; j < soft.size(); j++)
+      w += maxsat_formula->getSoftClause(soft[j]).weight;
+    v.push_back(std::make_pair(w, _nonEmpty[i]));
+  }
+
+  // Ties are broken by size as in 'orderBySize'.
+  std::sort(v.begin(), v.end(),
+            [this](const std::pair<uint64_t, int> &a,
+                   const std::pair<uint64_t, int> &b) {
+              if (a.first != b.first)
+                return a.first > b.first;
+              if (_soft[a.second].size() != _soft[b.second].size())
+                return _soft[a.second].size() < _soft[b.second].size();
+              return a.second < b.second;
+            });
+  for (size_t i = 0; i < v.size(); i++)
+    order.push(v[i].second);
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  orderByAdjacency : (order : vec<int>&) ->  [void]
+  |
+  |  Description:
+  |
+  |    Breadth-first search over the partition graph. Each search starts in
+  |    the smallest partition not visited yet, and the neighbors of a
+  |    partition are visited by decreasing weight of the shared variables.
+  |    Partitions without soft clauses are traversed but not scheduled.
+  |
+  |________________________________________________________________________________________________@*/
+void PartitionSchedule::orderByAdjacency(vec<int> &order) {
+  vec<int> starts;
+  orderBySize(starts);
+
+  Graph *g = buildPartitionGraph();
+  vec<bool> visited;
+  visited.growTo(g->nVertexes(), false);
+  vec<int> queue;
+  std::vector<std::pair<double, int>> neighbors;
+
+  for (int s = 0; s < starts.size(); s++) {
+    if (visited[starts[s]])
+      continue;
+
+    queue.clear();
+    queue.push(starts[s]);
+    visited[starts[s]] = true;
+    for (int head = 0; head < queue.size(); head++) {
+      int u = queue[head];
+      if (_soft[u].size() > 0)
+        order.push(u);
+
+      neighbors.clear();
+      vec<int> &edges = g->vertexEdges(u);
+      vec<double> &weights = g->vertexWeights(u);
+      for (int i = 0; i < edges.size(); i++)
+        if (!visited[edges[i]])
+          neighbors.push_back(std::make_pair(-weights[i], edges[i]));
+      std::sort(neighbors.begin(), neighbors.end());
+
+      for (size_t i = 0; i < neighbors.size(); i++) {
+        visited[neighbors[i].second] = true;
+        queue.push(neighbors[i].second);
+      }
+    }
+  }
+
+  delete g;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  orderByCores : (order : vec<int>&) ->  [void]
+  |
+  |  Description:
+  |
+  |    Estimates how many cores are local to each partition. A hard clause
+  |    where most literals are the complement of literals of soft clauses of
+  |    a partition cannot be satisfied together with them, e.g. a hard clause
+  |    whose literals all falsify unit soft clauses of the partition is a
+  |    core. Each hard clause adds to a partition the square of the fraction
+  |    of its literals that are complements of soft literals of the partition,
+  |    and the estimate is normalized by the number of soft clauses.
+  |
+  |________________________________________________________________________________________________@*/
+void PartitionSchedule::orderByCores(vec<int> &order) {
+  vec<vec<int>> litPartitions;
+  litPartitions.growTo(2 * maxsat_formula->nVars());
+  for (int i = 0; i < _nonEmpty.size(); i++) {
+    int p = _nonEmpty[i];
+    for (int j = 0; j < _soft[p].size(); j++) {
+      vec<Lit> &c = maxsat_formula->getSoftClause(_soft[p][j]).clause;
+      for (int k = 0; k < c.size(); k++) {
+        vec<int> &lp = litPartitions[toInt(c[k])];
+        if (lp.size() == 0 || lp.last() != p)
+          lp.push(p);
+      }
+    }
+  }
+
+  vec<double> density;
+  density.growTo(_soft.size(), 0);
+  vec<int> count;
+  count.growTo(_soft.size(), 0);
+  vec<int> touched;
+  for (int i = 0; i < maxsat_formula->nHard(); i++) {
+    vec<Lit> &c = maxsat_formula->getHardClause(i).clause;
+    for (int k = 0; k < c.size(); k++) {
+      vec<int> &lp = litPartitions[toInt(~c[k])];
+      for (int j = 0; j < lp.size(); j++) {
+        if (count[lp[j]]++ == 0)
+          touched.push(lp[j]);
+      }
+    }
+
+    for (int j = 0; j < touched.size(); j++) {
+      double f = (double)count[touched[j]] / c.size();
+      density[touched[j]] += f * f;
+      count[touched[j]] = 0;
+    }
+    touched.clear();
+  }
+
+  std::vector<std::pair<double, int>> v;
+  for (int i = 0; i < _nonEmpty.size(); i++) {
+    int p = _nonEmpty[i];
+    v.push_back(std::make_pair(-density[p] / _soft[p].size(), p));
+  }
+
+  std::sort(v.begin(), v.end());
+  for (size_t i = 0; i < v.size(); i++)
+    order.push(v[i].second);
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  buildPartitionGraph : [void] ->  [Graph *]
+  |
+  |  Description:
+  |
+  |    Builds a graph with a vertex for each partition, where the weight of an
+  |    edge is the number of variables shared by both partitions. A variable
+  |    in m partitions contributes 1/(m-1) to each pair, and is only
+  |    connected as a chain if m is larger than MAX_CLIQUE_PARTITIONS.
+  |
+  |________________________________________________________________________________________________@*/
+Graph *PartitionSchedule::buildPartitionGraph() {
+  int n = _soft.size();
+
+  _varPartitions.clear();
+  _varPartitions.growTo(maxsat_formula->nVars());
+  for (int i = 0; i < maxsat_formula->nHard(); i++) {
+    int p = maxsat_formula->getHardClause(i).getPartition();
+    if (p < 0 || p > maxsat_formula->nPartitions())
+      p = n - 1;
+    addClausePartition(p, maxsat_formula->getHardClause(i).clause);
+  }
+  for (int p = 0; p < n; p++)
+    for (int j = 0; j < _soft[p].size(); j++)
+      addClausePartition(p, maxsat_formula->getSoftClause(_soft[p][j]).clause);
+
+  Graph *g = new Graph(n);
+  for (int v = 0; v < _varPartitions.size(); v++) {
+    vec<int> &vp = _varPartitions[v];
+    sort(vp);
+    int m = 0;
+    for (int i = 0; i < vp.size(); i++)
+      if (m == 0 || vp[m - 1] != vp[i])
+        vp[m++] = vp[i];
+    vp.shrink(vp.size() - m);
+    if (vp.size() < 2)
+      continue;
+
+    if (vp.size() > MAX_CLIQUE_PARTITIONS) {
+      for (int i = 1; i < vp.size(); i++) {
+        g->addEdge(vp[i - 1], vp[i]);
+        g->addEdge(vp[i], vp[i - 1]);
+      }
+    } else {
+      double w = 1.0 / (vp.size() - 1);
+      for (int i = 0; i < vp.size(); i++)
+        for (int j = i + 1; j < vp.size(); j++) {
+          g->addEdge(vp[i], vp[j], w);
+          g->addEdge(vp[j], vp[i], w);
+        }
+    }
+  }
+  g->mergeDuplicatedEdges();
+  _varPartitions.clear();
+
+  return g;
+}
+
+void PartitionSchedule::addClausePartition(int p, vec<Lit> &c) {
+  for (int k = 0; k < c.size(); k++) {
+    vec<int> &vp = _varPartitions[var(c[k])];
+    // Clauses of the same partition are usually consecutive.
+    if (vp.size() == 0 || vp.last() != p)
+      vp.push(p);
+  }
+}
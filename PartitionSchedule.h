@@ -0,0 +1,79 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#ifndef PARTITION_SCHEDULE_H
+#define PARTITION_SCHEDULE_H
+
+#include "MaxSATFormula.h"
+#include "MaxTypes.h"
+#include "graph/Graph.h"
+
+using NSPACE::vec;
+
+namespace upmax {
+
+// Groups the soft clauses of a formula by partition and decides the order in
+// which the partitions are added to the formula by the Up* algorithms.
+class PartitionSchedule {
+
+public:
+  PartitionSchedule(MaxSATFormula *mx, int order = _ORDER_SIZE_)
+      : maxsat_formula(mx), _order(order) {}
+
+  // Fills 'partitions' with the soft clauses of each non-empty partition, in
+  // the order they should be solved.
+  void build(vec<vec<int>> &partitions);
+
+  // Fills 'level' with the soft clauses of weight 'weight' of each partition
+  // of 'partitions', in the same order and without the partitions that have
+  // none (lexicographic search).
+  void buildLevel(const vec<vec<int>> &partitions, uint64_t weight,
+                  vec<vec<int>> &level);
+
+protected:
+  void orderBySize(vec<int> &order);
+  void orderByWeight(vec<int> &order);
+  void orderByAdjacency(vec<int> &order);
+  void orderByCores(vec<int> &order);
+
+  // Graph where partitions are connected if they share variables.
+  Graph *buildPartitionGraph();
+  void addClausePartition(int p, vec<Lit> &c);
+
+  MaxSATFormula *maxsat_formula;
+  int _order;
+
+  vec<vec<int>> _soft;          // Soft clauses of each partition.
+  vec<vec<int>> _varPartitions; // Partitions where each variable occurs.
+  vec<int> _nonEmpty;           // Partitions with soft clauses.
+};
+
+} // namespace upmax
+
+#endif // PARTITION_SCHEDULE_H
@@ -0,0 +1,193 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "Portfolio.h"
+
+#include <thread>
+#include <vector>
+
+using namespace upmax;
+
+Portfolio::~Portfolio() {
+  for (int i = 0; i < _solvers.size(); i++)
+    delete _solvers[i];
+}
+
+void Portfolio::add(MaxSAT *S) {
+  S->setPortfolio(this, _solvers.size());
+  _solvers.push(S);
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  updateUB : (id : int) (cost : uint64_t) (model : vec<lbool>&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Publishes a new model of solver 'id' and its cost. Costs are printed in
+  |    decreasing order, even if two solvers improve the upper bound at the
+  |    same time.
+  |
+  |________________________________________________________________________________________________@*/
+void Portfolio::updateUB(int id, uint64_t cost, vec<lbool> &model) {
+  uint64_t ub = _ub.load();
+  while (cost < ub && !_ub.compare_exchange_weak(ub, cost))
+    ;
+  if (cost >= ub)
+    return;
+
+  {
+    std::lock_guard<std::mutex> guard(_model_lock);
+    if (cost < _modelCost) {
+      _modelCost = cost;
+      model.copyTo(_model);
+      _modelOwner = id;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(_print_lock);
+    if (cost == _ub.load() && cost < _printed) {
+      _printed = cost;
+      printf("o %" PRIu64 "\n", cost);
+      fflush(stdout);
+    }
+  }
+
+  if (_lb.load() >= cost && finish(best(), _OPTIMUM_))
+    stop();
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  updateLB : (cost : uint64_t)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Publishes the lower bound of a solver. If it meets the best upper
+  |    bound, the best model is optimal and all solvers are stopped.
+  |
+  |________________________________________________________________________________________________@*/
+void Portfolio::updateLB(uint64_t cost) {
+  uint64_t lb = _lb.load();
+  while (cost > lb && !_lb.compare_exchange_weak(lb, cost))
+    ;
+  if (cost <= lb)
+    return;
+
+  if (cost >= _ub.load() && finish(best(), _OPTIMUM_))
+    stop();
+}
+
+bool Portfolio::importModel(vec<lbool> &model, uint64_t cost) {
+  if (_ub.load() >= cost)
+    return false;
+
+  std::lock_guard<std::mutex> guard(_model_lock);
+  if (_modelCost >= cost)
+    return false;
+  _model.copyTo(model);
+  return true;
+}
+
+// Solver with the cheapest model (0 if no solver has a model).
+int Portfolio::best() {
+  int id = _modelOwner.load();
+  return id == -1 ? 0 : id;
+}
+
+bool Portfolio::finish(int id, StatusCode status) {
+  int none = -1;
+  if (!_winner.compare_exchange_strong(none, id))
+    return false;
+  _status = status;
+  return true;
+}
+
+void Portfolio::stop() {
+  for (int i = 0; i < _solvers.size(); i++)
+    _solvers[i]->interrupt();
+}
+
+void Portfolio::run(int id) {
+  StatusCode status = _UNKNOWN_;
+  try {
+    status = _solvers[id]->search();
+  } catch (InterruptException &) {
+    return;
+  } catch (NSPACE::OutOfMemoryException &) {
+    printf("c Error: Out of memory in solver %d.\n", id);
+    return;
+  } catch (MaxSATException &e) {
+    printf("c Error: MaxSAT Exception in solver %d: %s\n", id, e.getMsg());
+    return;
+  }
+
+  if ((status == _OPTIMUM_ || status == _UNSATISFIABLE_) &&
+      finish(id, status))
+    stop();
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  search : [void]  ->  [StatusCode]
+  |
+  |  Description:
+  |
+  |    Runs each solver in its own thread until one of them finishes. The
+  |    answer is printed by the solver that finished, or by the solver with
+  |    the best model if the bounds met or no solver finished.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode Portfolio::search() {
+  std::vector<std::thread> pool;
+  for (int i = 0; i < _solvers.size(); i++)
+    pool.emplace_back(&Portfolio::run, this, i);
+  for (unsigned i = 0; i < pool.size(); i++)
+    pool[i].join();
+
+  int id = _winner.load();
+  if (id == -1) {
+    printAnswer(_UNKNOWN_);
+    return _solvers[best()]->getStatus();
+  }
+
+  // Any optimal model is printed by the solver that found it first.
+  MaxSAT *S = _solvers[id];
+  if (_status == _OPTIMUM_ && _modelOwner.load() != -1)
+    S = _solvers[best()];
+  S->setPrint(true);
+  S->printAnswer(_status);
+  return _status;
+}
+
+void Portfolio::printAnswer(int type) {
+  MaxSAT *S = _solvers[best()];
+  S->setPrint(true);
+  S->printAnswer(type);
+}
@@ -0,0 +1,101 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include "MaxSAT.h"
+
+#include <atomic>
+#include <mutex>
+
+using NSPACE::lbool;
+using NSPACE::vec;
+
+namespace upmax {
+
+// Runs several MaxSAT solvers in parallel on copies of the same formula.
+// The solvers publish their bounds to shared slots: each model improves the
+// upper bound and each SAT call first publishes the lower bound of its
+// solver. As soon as one solver finishes, or the best lower bound meets the
+// best upper bound, the remaining solvers are interrupted.
+class Portfolio {
+
+public:
+  Portfolio()
+      : _ub(UINT64_MAX), _lb(0), _printed(UINT64_MAX),
+        _modelCost(UINT64_MAX), _modelOwner(-1), _winner(-1),
+        _status(_UNKNOWN_) {}
+  ~Portfolio();
+
+  // The portfolio takes ownership of 'S'. Solvers must not print.
+  void add(MaxSAT *S);
+
+  // Searches with all solvers and prints the answer of the best one.
+  StatusCode search();
+
+  // May be called from any solver thread. 'model' is a model of solver 'id'.
+  void updateUB(int id, uint64_t cost, vec<lbool> &model);
+  void updateLB(uint64_t cost);
+
+  // Copies the best model to 'model' if it costs less than 'cost'.
+  bool importModel(vec<lbool> &model, uint64_t cost);
+
+  // Prints the answer of the solver with the best model.
+  void printAnswer(int type);
+
+protected:
+  void run(int id);
+  // Claims the answer for solver 'id'. Only the first claim succeeds.
+  bool finish(int id, StatusCode status);
+  void stop();
+  int best();
+
+  vec<MaxSAT *> _solvers;
+
+  std::atomic<uint64_t> _ub; // Cost of the best model of all solvers.
+  std::atomic<uint64_t> _lb; // Best lower bound of all solvers.
+
+  std::mutex _print_lock;
+  uint64_t _printed; // Last cost printed (protected by '_print_lock').
+
+  std::mutex _model_lock;
+  vec<lbool> _model;   // Best model (protected by '_model_lock').
+  uint64_t _modelCost; // Cost of '_model' (protected by '_model_lock').
+  // Solver that found '_model' (-1 if none). Only written with '_model_lock',
+  // but read without it, such that 'best' can be called from the signal
+  // handler.
+  std::atomic<int> _modelOwner;
+
+  std::atomic<int> _winner; // Solver that claimed the answer (-1 if none).
+  StatusCode _status;       // Answer of '_winner'.
+};
+
+} // namespace upmax
+
+#endif
@@ -0,0 +1,98 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#include "SubsetSum.h"
+
+using namespace upmax;
+
+void SubsetSum::clear() {
+  _words.clear();
+  _words.push(1);
+  _total = 0;
+  _overflow = false;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  add : (weight : uint64_t) ->  [void]
+  |
+  |  Description:
+  |
+  |    Adds 'weight' to the multiset. The new reachable sums are the previous
+  |    ones shifted by 'weight', hence the bitset is or-ed with a copy of
+  |    itself shifted left. The bitset is traversed from the highest word such
+  |    that each word is only read before it is updated.
+  |
+  |  Post-conditions:
+  |    * If the sum of the weights exceeds '_max_sum', the bitset is dropped
+  |      and 'next' no longer moves the bound.
+  |
+  |________________________________________________________________________________________________@*/
+void SubsetSum::add(uint64_t weight) {
+  if (_overflow || weight == 0)
+    return;
+
+  _total += weight;
+  if (_total > _max_sum) {
+    _overflow = true;
+    _words.clear();
+    return;
+  }
+
+  int n = (int)(_total >> 6) + 1;
+  _words.growTo(n, 0);
+
+  int word_shift = (int)(weight >> 6);
+  int bit_shift = (int)(weight & 63);
+
+  if (bit_shift == 0) {
+    for (int i = n - 1; i >= word_shift; i--)
+      _words[i] |= _words[i - word_shift];
+  } else {
+    for (int i = n - 1; i > word_shift; i--)
+      _words[i] |= (_words[i - word_shift] << bit_shift) |
+                   (_words[i - word_shift - 1] >> (64 - bit_shift));
+    _words[word_shift] |= _words[0] << bit_shift;
+  }
+}
+
+uint64_t SubsetSum::next(uint64_t sum) {
+  if (_overflow || sum > _total)
+    return sum;
+
+  int i = (int)(sum >> 6);
+  uint64_t word = _words[i] & (~(uint64_t)0 << (sum & 63));
+  while (word == 0) {
+    // The total is always reachable.
+    assert(i + 1 < _words.size());
+    word = _words[++i];
+  }
+
+  return ((uint64_t)i << 6) + __builtin_ctzll(word);
+}
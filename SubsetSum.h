@@ -0,0 +1,73 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#ifndef SUBSET_SUM_H
+#define SUBSET_SUM_H
+
+#include "mtl/Vec.h"
+#include <stdint.h>
+
+using NSPACE::vec;
+
+namespace upmax {
+
+// Set of sums reachable by subsets of a growing multiset of weights, stored
+// as a bitset where bit i is set if some subset sums to i. Used to move the
+// lower bound of weighted algorithms to the next achievable cost.
+class SubsetSum {
+
+public:
+  SubsetSum(uint64_t max_sum = _DEFAULT_MAX_SUM_) : _max_sum(max_sum) {
+    clear();
+  }
+
+  // Removes all weights. Only the empty sum is reachable.
+  void clear();
+
+  // Adds a weight to the multiset, updating the reachable sums.
+  void add(uint64_t weight);
+
+  // Smallest reachable sum that is greater or equal to 'sum'. If there is no
+  // such sum, or if the weights exceed the maximum sum, 'sum' is returned.
+  uint64_t next(uint64_t sum);
+
+  uint64_t total() { return _total; }
+
+protected:
+  static const uint64_t _DEFAULT_MAX_SUM_ = (uint64_t)1 << 30;
+
+  vec<uint64_t> _words; // Bitset of reachable sums.
+  uint64_t _total;      // Sum of all weights.
+  uint64_t _max_sum;    // Largest sum that is represented.
+  bool _overflow;       // The sum of all weights exceeds '_max_sum'.
+};
+
+} // namespace upmax
+
+#endif // SUBSET_SUM_H
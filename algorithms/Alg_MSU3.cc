@@ -79,8 +79,6 @@ StatusCode MSU3::MSU3_iterative() {
   encoder.setIncremental(_INCREMENTAL_ITERATIVE_);
 
   activeSoft.growTo(maxsat_formula->nSoft(), false);
-  for (int i = 0; i < maxsat_formula->nSoft(); i++)
-    coreMapping[getAssumptionLit(i)] = i;
 
   for (;;) {
 
@@ -132,11 +130,12 @@ StatusCode MSU3::MSU3_iterative() {
 
       joinObjFunction.clear();
       for (int i = 0; i < solver->conflict.size(); i++) {
-        if (coreMapping.find(solver->conflict[i]) != coreMapping.end()) {
-          assert(!activeSoft[coreMapping[solver->conflict[i]]]);
-          activeSoft[coreMapping[solver->conflict[i]]] = true;
+        int index_soft = softIndex(solver->conflict[i]);
+        if (index_soft != -1) {
+          assert(!activeSoft[index_soft]);
+          activeSoft[index_soft] = true;
           joinObjFunction.push(
-              getRelaxationLit(coreMapping[solver->conflict[i]]));
+              getRelaxationLit(index_soft));
         }
       }
 
@@ -213,8 +212,6 @@ StatusCode MSU3::MSU3_bmo() {
   int current_bmo_function = 0;
 
   activeSoft.growTo(maxsat_formula->nSoft(), false);
-  for (int i = 0; i < maxsat_formula->nSoft(); i++)
-    coreMapping[getAssumptionLit(i)] = i;
 
   for (;;) {
 
@@ -314,14 +311,15 @@ StatusCode MSU3::MSU3_bmo() {
 
       joinObjFunction.clear();
       for (int i = 0; i < solver->conflict.size(); i++) {
-        if (coreMapping.find(solver->conflict[i]) != coreMapping.end()) {
-          //if (activeSoft[coreMapping[solver->conflict[i]]]) continue;
-          //printf("active soft = %d\n",coreMapping[solver->conflict[i]]);
-          assert(!activeSoft[coreMapping[solver->conflict[i]]]);
-          activeSoft[coreMapping[solver->conflict[i]]] = true;
-          lastSoft.insert(coreMapping[solver->conflict[i]]);
+        int index_soft = softIndex(solver->conflict[i]);
+        if (index_soft != -1) {
+          //if (activeSoft[index_soft]) continue;
+          //printf("active soft = %d\n",index_soft);
+          assert(!activeSoft[index_soft]);
+          activeSoft[index_soft] = true;
+          lastSoft.insert(index_soft);
           joinObjFunction.push(
-              getRelaxationLit(coreMapping[solver->conflict[i]]));
+              getRelaxationLit(index_soft));
         }
       }
 
@@ -522,6 +520,7 @@ void MSU3::initRelaxation() {
     Soft &s = getSoftClause(i);
     s.relaxation_vars.push(l);
     s.assumption_var = l;
+    setCoreMapping(l, i);
     objFunction.push(l);
     coeffs.push(s.weight);
   }
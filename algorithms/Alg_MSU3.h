@@ -105,9 +105,6 @@ protected:
   vec<int> coeffs; // Coefficients of the literals that are used in the
                    // constraint that excludes models.
 
-  std::map<Lit, int> coreMapping; // Mapping between the assumption literal and
-                                  // the respective soft clause.
-
   // Soft clauses that are currently in the MaxSAT formula.
   vec<bool> activeSoft;
 };
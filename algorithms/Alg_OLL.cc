@@ -30,8 +30,7 @@
 
 using namespace upmax;
 
-uint64_t OLL::findNextWeight(uint64_t weight,
-                             std::set<Lit> &cardinality_assumptions) {
+uint64_t OLL::findNextWeight(uint64_t weight) {
 
   uint64_t nextWeight = 1;
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
@@ -40,19 +39,16 @@ uint64_t OLL::findNextWeight(uint64_t weight,
       nextWeight = maxsat_formula->getSoftClause(i).weight;
   }
 
-  for (std::set<Lit>::iterator it = cardinality_assumptions.begin();
-       it != cardinality_assumptions.end(); ++it) {
-    assert(boundMapping.find(*it) != boundMapping.end());
-    std::pair<std::pair<int, uint64_t>, uint64_t> soft_id = boundMapping[*it];
-    if (soft_id.second > nextWeight && soft_id.second < weight)
-      nextWeight = soft_id.second;
+  for (Lit q = bounds.first(); q != lit_Undef; q = bounds.next(q)) {
+    uint64_t w = bounds.weight(q);
+    if (w > nextWeight && w < weight)
+      nextWeight = w;
   }
 
   return nextWeight;
 }
 
-uint64_t OLL::findNextWeightDiversity(uint64_t weight,
-                                      std::set<Lit> &cardinality_assumptions) {
+uint64_t OLL::findNextWeightDiversity(uint64_t weight) {
 
   assert(nbSatisfiable > 0); // Assumes that unsatSearch was done before.
 
@@ -65,7 +61,7 @@ uint64_t OLL::findNextWeightDiversity(uint64_t weight,
 
   for (;;) {
     if (nbSatisfiable > 1 || findNext)
-      nextWeight = findNextWeight(nextWeight, cardinality_assumptions);
+      nextWeight = findNextWeight(nextWeight);
 
     nbClauses = 0;
     nbWeights.clear();
@@ -76,19 +72,17 @@ uint64_t OLL::findNextWeightDiversity(uint64_t weight,
       }
     }
 
-    for (std::set<Lit>::iterator it = cardinality_assumptions.begin();
-         it != cardinality_assumptions.end(); ++it) {
-      assert(boundMapping.find(*it) != boundMapping.end());
-      std::pair<std::pair<int, uint64_t>, uint64_t> soft_id = boundMapping[*it];
-      if (soft_id.second >= nextWeight) {
+    for (Lit q = bounds.first(); q != lit_Undef; q = bounds.next(q)) {
+      uint64_t w = bounds.weight(q);
+      if (w >= nextWeight) {
         nbClauses++;
-        nbWeights.insert(soft_id.second);
+        nbWeights.insert(w);
       }
     }
 
     if ((float)nbClauses / nbWeights.size() > alpha ||
         (unsigned)nbClauses ==
-            (unsigned)maxsat_formula->nSoft() + cardinality_assumptions.size())
+            (unsigned)maxsat_formula->nSoft() + bounds.nActive())
       break;
 
     if (nbSatisfiable == 1 && !findNext)
@@ -113,10 +107,7 @@ StatusCode OLL::unweighted() {
   encoder.setIncremental(_INCREMENTAL_ITERATIVE_);
 
   activeSoft.growTo(maxsat_formula->nSoft(), false);
-  for (int i = 0; i < maxsat_formula->nSoft(); i++)
-    coreMapping[maxsat_formula->getSoftClause(i).assumption_var] = i;
 
-  std::set<Lit> cardinality_assumptions;
   vec<Encoder *> soft_cardinality;
 
   for (;;) {
@@ -158,6 +149,7 @@ StatusCode OLL::unweighted() {
     }
 
     if (res == l_False) {
+      minimizeCore(solver, solver->conflict);
       lbCost++;
       nbCores++;
       if (verbosity > 0)
@@ -183,48 +175,38 @@ StatusCode OLL::unweighted() {
 
       for (int i = 0; i < solver->conflict.size(); i++) {
         Lit p = solver->conflict[i];
-        if (coreMapping.find(p) != coreMapping.end()) {
-          assert(!activeSoft[coreMapping[p]]);
-          activeSoft[coreMapping[solver->conflict[i]]] = true;
+        int index_soft = softIndex(p);
+        if (index_soft != -1) {
+          assert(!activeSoft[index_soft]);
+          activeSoft[index_soft] = true;
           assert(p ==
-                 maxsat_formula->getSoftClause(coreMapping[solver->conflict[i]])
-                     .relaxation_vars[0]);
+                 maxsat_formula->getSoftClause(index_soft).relaxation_vars[0]);
           soft_relax.push(p);
         }
 
-        if (boundMapping.find(p) != boundMapping.end()) {
-          std::set<Lit>::iterator it;
-          it = cardinality_assumptions.find(p);
-          assert(it != cardinality_assumptions.end());
-          cardinality_assumptions.erase(it);
+        if (bounds.has(p)) {
+          bounds.deactivate(p);
           cardinality_relax.push(p);
 
           // this is a soft cardinality -- bound must be increased
-          std::pair<std::pair<int, int>, int> soft_id =
-              boundMapping[solver->conflict[i]];
+          int id = bounds.id(p);
+          int bound = bounds.bound(p);
           // increase the bound
-          assert(soft_id.first.first < soft_cardinality.size());
-          assert(soft_cardinality[soft_id.first.first]->hasCardEncoding());
+          assert(id < soft_cardinality.size());
+          assert(soft_cardinality[id]->hasCardEncoding());
 
           joinObjFunction.clear();
           encodingAssumptions.clear();
-          soft_cardinality[soft_id.first.first]->incUpdateCardinality(
-              solver, joinObjFunction,
-              soft_cardinality[soft_id.first.first]->lits(),
-              soft_id.first.second + 1, encodingAssumptions);
+          soft_cardinality[id]->incUpdateCardinality(
+              solver, joinObjFunction, soft_cardinality[id]->lits(), bound + 1,
+              encodingAssumptions);
 
           // if the bound is the same as the number of lits then no restriction
           // is applied
-          if (soft_id.first.second + 1 <
-              soft_cardinality[soft_id.first.first]->outputs().size()) {
-            assert(soft_cardinality[soft_id.first.first]->outputs().size() >
-                   soft_id.first.second + 1);
-            Lit out = soft_cardinality[soft_id.first.first]
-                          ->outputs()[soft_id.first.second + 1];
-            boundMapping[out] = std::make_pair(
-                std::make_pair(soft_id.first.first, soft_id.first.second + 1),
-                1);
-            cardinality_assumptions.insert(out);
+          if (bound + 1 < soft_cardinality[id]->outputs().size()) {
+            Lit out = soft_cardinality[id]->outputs()[bound + 1];
+            bounds.set(out, id, bound + 1, 1);
+            bounds.activate(out);
           }
         }
       }
@@ -267,9 +249,8 @@ StatusCode OLL::unweighted() {
         assert(e->outputs().size() > 1);
 
         Lit out = e->outputs()[1];
-        boundMapping[out] =
-            std::make_pair(std::make_pair(soft_cardinality.size() - 1, 1), 1);
-        cardinality_assumptions.insert(out);
+        bounds.set(out, soft_cardinality.size() - 1, 1, 1);
+        bounds.activate(out);
       }
 
       // reset the assumptions
@@ -282,10 +263,8 @@ StatusCode OLL::unweighted() {
           active_soft++;
       }
 
-      for (std::set<Lit>::iterator it = cardinality_assumptions.begin();
-           it != cardinality_assumptions.end(); ++it) {
-        assumptions.push(~(*it));
-      }
+      for (Lit q = bounds.first(); q != lit_Undef; q = bounds.next(q))
+        assumptions.push(~q);
 
       if (verbosity > 0) {
         printf("c Relaxed soft clauses %d / %d\n", active_soft,
@@ -308,10 +287,7 @@ StatusCode OLL::weighted() {
   encoder.setIncremental(_INCREMENTAL_ITERATIVE_);
 
   activeSoft.growTo(maxsat_formula->nSoft(), false);
-  for (int i = 0; i < maxsat_formula->nSoft(); i++)
-    coreMapping[maxsat_formula->getSoftClause(i).assumption_var] = i;
 
-  std::set<Lit> cardinality_assumptions;
   vec<Encoder *> soft_cardinality;
 
   min_weight = maxsat_formula->getMaximumWeight();
@@ -337,7 +313,7 @@ StatusCode OLL::weighted() {
 
       if (nbSatisfiable == 1) {
         min_weight =
-            findNextWeightDiversity(min_weight, cardinality_assumptions);
+            findNextWeightDiversity(min_weight);
         // printf("current weight %d\n",min_weight);
 
         for (int i = 0; i < maxsat_formula->nSoft(); i++)
@@ -353,18 +329,14 @@ StatusCode OLL::weighted() {
 
         // printf("not considered %d\n",not_considered);
 
-        for (std::set<Lit>::iterator it = cardinality_assumptions.begin();
-             it != cardinality_assumptions.end(); ++it) {
-          assert(boundMapping.find(*it) != boundMapping.end());
-          std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-              boundMapping[*it];
-          if (soft_id.second < min_weight)
+        for (Lit q = bounds.first(); q != lit_Undef; q = bounds.next(q)) {
+          if (bounds.weight(q) < min_weight)
             not_considered++;
         }
 
         if (not_considered != 0) {
           min_weight =
-              findNextWeightDiversity(min_weight, cardinality_assumptions);
+              findNextWeightDiversity(min_weight);
 
           // printf("currentWeight %d\n",currentWeight);
 
@@ -383,14 +355,10 @@ StatusCode OLL::weighted() {
           }
 
           // printf("assumptions %d\n",assumptions.size());
-          for (std::set<Lit>::iterator it = cardinality_assumptions.begin();
-               it != cardinality_assumptions.end(); ++it) {
-            assert(boundMapping.find(*it) != boundMapping.end());
-            std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-                boundMapping[*it];
-            if (soft_id.second >= min_weight)
-              assumptions.push(~(*it));
-            // printf("c assumption %d\n",var(*it)+1);
+          for (Lit q = bounds.first(); q != lit_Undef; q = bounds.next(q)) {
+            if (bounds.weight(q) >= min_weight)
+              assumptions.push(~q);
+            // printf("c assumption %d\n",var(q)+1);
           }
 
         } else {
@@ -402,26 +370,21 @@ StatusCode OLL::weighted() {
     }
 
     if (res == l_False) {
+      minimizeCore(solver, solver->conflict);
 
       // reduce the weighted to the unweighted case
       uint64_t min_core = UINT64_MAX;
       for (int i = 0; i < solver->conflict.size(); i++) {
         Lit p = solver->conflict[i];
-        if (coreMapping.find(p) != coreMapping.end()) {
-          assert(!activeSoft[coreMapping[p]]);
-          if (maxsat_formula->getSoftClause(coreMapping[solver->conflict[i]])
-                  .weight < min_core)
-            min_core =
-                maxsat_formula->getSoftClause(coreMapping[solver->conflict[i]])
-                    .weight;
+        int index_soft = softIndex(p);
+        if (index_soft != -1) {
+          assert(!activeSoft[index_soft]);
+          if (maxsat_formula->getSoftClause(index_soft).weight < min_core)
+            min_core = maxsat_formula->getSoftClause(index_soft).weight;
         }
 
-        if (boundMapping.find(p) != boundMapping.end()) {
-          std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-              boundMapping[solver->conflict[i]];
-          if (soft_id.second < min_core)
-            min_core = soft_id.second;
-        }
+        if (bounds.has(p) && bounds.weight(p) < min_core)
+          min_core = bounds.weight(p);
       }
 
       // printf("MIN CORE %d\n",min_core);
@@ -451,12 +414,13 @@ StatusCode OLL::weighted() {
 
       for (int i = 0; i < solver->conflict.size(); i++) {
         Lit p = solver->conflict[i];
-        if (coreMapping.find(p) != coreMapping.end()) {
-          if (maxsat_formula->getSoftClause(coreMapping[p]).weight > min_core) {
+        int index_soft = softIndex(p);
+        if (index_soft != -1) {
+          if (maxsat_formula->getSoftClause(index_soft).weight > min_core) {
             // printf("SPLIT THE CLAUSE\n");
-            assert(!activeSoft[coreMapping[p]]);
+            assert(!activeSoft[index_soft]);
             // SPLIT THE CLAUSE
-            int indexSoft = coreMapping[p];
+            int indexSoft = index_soft;
             assert(maxsat_formula->getSoftClause(indexSoft).weight - min_core >
                    0);
 
@@ -499,68 +463,54 @@ StatusCode OLL::weighted() {
                        .assumption_var ==
                    maxsat_formula->getSoftClause(maxsat_formula->nSoft() - 1)
                        .relaxation_vars[0]);
-            coreMapping[l] =
-                maxsat_formula->nSoft() -
-                1; // Map the new soft clause to its assumption literal.
+            // Map the new soft clause to its assumption literal.
+            setCoreMapping(l, maxsat_formula->nSoft() - 1);
 
             soft_relax.push(l);
-            assert(maxsat_formula->getSoftClause(coreMapping[l]).weight ==
+            assert(maxsat_formula->getSoftClause(softIndex(l)).weight ==
                    min_core);
             assert(activeSoft.size() == maxsat_formula->nSoft());
 
           } else {
             // printf("NOT SPLITTING\n");
-            assert(
-                maxsat_formula->getSoftClause(coreMapping[solver->conflict[i]])
-                    .weight == min_core);
+            assert(maxsat_formula->getSoftClause(index_soft).weight ==
+                   min_core);
             soft_relax.push(p);
             // printf("ASSERT %d\n",var(p)+1);
-            assert(!activeSoft[coreMapping[p]]);
-            activeSoft[coreMapping[p]] = true;
+            assert(!activeSoft[index_soft]);
+            activeSoft[index_soft] = true;
           }
         }
 
-        if (boundMapping.find(p) != boundMapping.end()) {
+        if (bounds.has(p)) {
           // printf("CARD IN CORE\n");
-
-          std::set<Lit>::iterator it;
-          it = cardinality_assumptions.find(p);
-          assert(it != cardinality_assumptions.end());
+          assert(bounds.isActive(p));
 
           // this is a soft cardinality -- bound must be increased
-          std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-              boundMapping[solver->conflict[i]];
+          int id = bounds.id(p);
+          uint64_t bound = bounds.bound(p);
+          uint64_t weight = bounds.weight(p);
           // increase the bound
-          assert(soft_id.first.first < soft_cardinality.size());
-          assert(soft_cardinality[soft_id.first.first]->hasCardEncoding());
+          assert(id < soft_cardinality.size());
+          assert(soft_cardinality[id]->hasCardEncoding());
 
-          if (soft_id.second == min_core) {
+          if (weight == min_core) {
 
-            cardinality_assumptions.erase(it);
+            bounds.deactivate(p);
             cardinality_relax.push(p);
 
             joinObjFunction.clear();
             encodingAssumptions.clear();
-            soft_cardinality[soft_id.first.first]->incUpdateCardinality(
-                solver, joinObjFunction,
-                soft_cardinality[soft_id.first.first]->lits(),
-                soft_id.first.second + 1, encodingAssumptions);
+            soft_cardinality[id]->incUpdateCardinality(
+                solver, joinObjFunction, soft_cardinality[id]->lits(),
+                bound + 1, encodingAssumptions);
 
             // if the bound is the same as the number of lits then no
             // restriction is applied
-            if (soft_id.first.second + 1 <
-                (unsigned)soft_cardinality[soft_id.first.first]
-                    ->outputs()
-                    .size()) {
-              assert((unsigned)soft_cardinality[soft_id.first.first]
-                         ->outputs()
-                         .size() > soft_id.first.second + 1);
-              Lit out = soft_cardinality[soft_id.first.first]
-                            ->outputs()[soft_id.first.second + 1];
-              boundMapping[out] = std::make_pair(
-                  std::make_pair(soft_id.first.first, soft_id.first.second + 1),
-                  min_core);
-              cardinality_assumptions.insert(out);
+            if (bound + 1 < (unsigned)soft_cardinality[id]->outputs().size()) {
+              Lit out = soft_cardinality[id]->outputs()[bound + 1];
+              bounds.set(out, id, bound + 1, min_core);
+              bounds.activate(out);
             }
 
           } else {
@@ -569,52 +519,34 @@ StatusCode OLL::weighted() {
             // duplicate cardinality constraint???
             Encoder *e = new Encoder();
             e->setIncremental(_INCREMENTAL_ITERATIVE_);
-            e->buildCardinality(solver,
-                                soft_cardinality[soft_id.first.first]->lits(),
-                                soft_id.first.second);
+            e->buildCardinality(solver, soft_cardinality[id]->lits(), bound);
 
-            assert((unsigned)e->outputs().size() > soft_id.first.second);
-            Lit out = e->outputs()[soft_id.first.second];
+            assert((unsigned)e->outputs().size() > bound);
+            Lit out = e->outputs()[bound];
             soft_cardinality.push(e);
 
-            boundMapping[out] =
-                std::make_pair(std::make_pair(soft_cardinality.size() - 1,
-                                              soft_id.first.second),
-                               min_core);
+            int core_id = soft_cardinality.size() - 1;
+            bounds.set(out, core_id, bound, min_core);
             cardinality_relax.push(out);
 
             // Update value of the previous cardinality constraint
-            assert(soft_id.second - min_core > 0);
-            boundMapping[p] = std::make_pair(
-                std::make_pair(soft_id.first.first, soft_id.first.second),
-                soft_id.second - min_core);
+            assert(weight - min_core > 0);
+            bounds.setWeight(p, weight - min_core);
 
             // Update bound as usual...
 
-            std::pair<std::pair<int, int>, int> soft_core_id =
-                boundMapping[out];
-
             joinObjFunction.clear();
             encodingAssumptions.clear();
-            soft_cardinality[soft_core_id.first.first]->incUpdateCardinality(
-                solver, joinObjFunction,
-                soft_cardinality[soft_core_id.first.first]->lits(),
-                soft_core_id.first.second + 1, encodingAssumptions);
+            soft_cardinality[core_id]->incUpdateCardinality(
+                solver, joinObjFunction, soft_cardinality[core_id]->lits(),
+                bound + 1, encodingAssumptions);
 
             // if the bound is the same as the number of lits then no
             // restriction is applied
-            if (soft_core_id.first.second + 1 <
-                soft_cardinality[soft_core_id.first.first]->outputs().size()) {
-              assert(
-                  soft_cardinality[soft_core_id.first.first]->outputs().size() >
-                  soft_core_id.first.second + 1);
-              Lit out = soft_cardinality[soft_core_id.first.first]
-                            ->outputs()[soft_core_id.first.second + 1];
-              boundMapping[out] =
-                  std::make_pair(std::make_pair(soft_core_id.first.first,
-                                                soft_core_id.first.second + 1),
-                                 min_core);
-              cardinality_assumptions.insert(out);
+            if (bound + 1 < (unsigned)soft_cardinality[core_id]->outputs().size()) {
+              Lit out = soft_cardinality[core_id]->outputs()[bound + 1];
+              bounds.set(out, core_id, bound + 1, min_core);
+              bounds.activate(out);
             }
 #else
 
@@ -637,43 +569,28 @@ StatusCode OLL::weighted() {
             clause.push(p);
             solver->addClause(clause);
 
-            boundMapping[l] = std::make_pair(
-                std::make_pair(soft_id.first.first, soft_id.first.second),
-                min_core);
+            bounds.set(l, id, bound, min_core);
             cardinality_relax.push(l);
 
             // Update bound as usual...
 
-            std::pair<std::pair<int, int>, int> soft_core_id = boundMapping[p];
-
             joinObjFunction.clear();
             encodingAssumptions.clear();
-            soft_cardinality[soft_core_id.first.first]->incUpdateCardinality(
-                solver, joinObjFunction,
-                soft_cardinality[soft_core_id.first.first]->lits(),
-                soft_core_id.first.second + 1, encodingAssumptions);
+            soft_cardinality[id]->incUpdateCardinality(
+                solver, joinObjFunction, soft_cardinality[id]->lits(),
+                bound + 1, encodingAssumptions);
 
             // if the bound is the same as the number of lits then no
             // restriction is applied
-            if (soft_core_id.first.second + 1 <
-                soft_cardinality[soft_core_id.first.first]->outputs().size()) {
-              assert(
-                  soft_cardinality[soft_core_id.first.first]->outputs().size() >
-                  soft_core_id.first.second + 1);
-              Lit out = soft_cardinality[soft_core_id.first.first]
-                            ->outputs()[soft_core_id.first.second + 1];
-              boundMapping[out] =
-                  std::make_pair(std::make_pair(soft_core_id.first.first,
-                                                soft_core_id.first.second + 1),
-                                 min_core);
-              cardinality_assumptions.insert(out);
+            if (bound + 1 < (unsigned)soft_cardinality[id]->outputs().size()) {
+              Lit out = soft_cardinality[id]->outputs()[bound + 1];
+              bounds.set(out, id, bound + 1, min_core);
+              bounds.activate(out);
             }
 
             // Update value of the previous cardinality constraint
-            assert(soft_id.second - min_core > 0);
-            boundMapping[p] = std::make_pair(
-                std::make_pair(soft_id.first.first, soft_id.first.second),
-                soft_id.second - min_core);
+            assert(weight - min_core > 0);
+            bounds.setWeight(p, weight - min_core);
 
 #endif
           }
@@ -719,9 +636,8 @@ StatusCode OLL::weighted() {
 
         // printf("outputs %d\n",e->outputs().size());
         Lit out = e->outputs()[1];
-        boundMapping[out] = std::make_pair(
-            std::make_pair(soft_cardinality.size() - 1, 1), min_core);
-        cardinality_assumptions.insert(out);
+        bounds.set(out, soft_cardinality.size() - 1, 1, min_core);
+        bounds.activate(out);
       }
 
       // reset the assumptions
@@ -737,14 +653,10 @@ StatusCode OLL::weighted() {
       }
 
       // printf("assumptions %d\n",assumptions.size());
-      for (std::set<Lit>::iterator it = cardinality_assumptions.begin();
-           it != cardinality_assumptions.end(); ++it) {
-        assert(boundMapping.find(*it) != boundMapping.end());
-        std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-            boundMapping[*it];
-        if (soft_id.second >= min_weight)
-          assumptions.push(~(*it));
-        // printf("c assumption %d\n",var(*it)+1);
+      for (Lit q = bounds.first(); q != lit_Undef; q = bounds.next(q)) {
+        if (bounds.weight(q) >= min_weight)
+          assumptions.push(~q);
+        // printf("c assumption %d\n",var(q)+1);
       }
 
       // printf("card assumptions %d\n",assumptions.size());
@@ -878,5 +790,6 @@ void OLL::initRelaxation() {
     Lit l = maxsat_formula->newLiteral();
     maxsat_formula->getSoftClause(i).relaxation_vars.push(l);
     maxsat_formula->getSoftClause(i).assumption_var = l;
+    setCoreMapping(l, i);
   }
 }
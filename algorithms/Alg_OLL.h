@@ -35,6 +35,7 @@
 #include "core/Solver.h"
 #endif
 
+#include "../CardinalityBounds.h"
 #include "../Encoder.h"
 #include "../MaxSAT.h"
 #include <map>
@@ -102,23 +103,14 @@ protected:
   vec<uint64_t> coeffs; // Coefficients of the literals that are used in the
                         // constraint that excludes models.
 
-  std::map<Lit, int> coreMapping; // Mapping between the assumption literal and
-                                  // the respective soft clause.
-
-  std::map<Lit, int>
-      coreCardinality; // Mapping between the assumption literal and
-                       // the respective soft clause.
-
-  // lit -> <ID, bound, weight>
-  std::map<Lit, std::pair<std::pair<int, uint64_t>, uint64_t>> boundMapping;
+  // Outputs of the soft cardinality constraints with their bounds and weights.
+  CardinalityBounds bounds;
 
   // Soft clauses that are currently in the MaxSAT formula.
   vec<bool> activeSoft;
 
-  uint64_t findNextWeightDiversity(uint64_t weight,
-                                   std::set<Lit> &cardinality_assumptions);
-  uint64_t findNextWeight(uint64_t weight,
-                          std::set<Lit> &cardinality_assumptions);
+  uint64_t findNextWeightDiversity(uint64_t weight);
+  uint64_t findNextWeight(uint64_t weight);
 
   uint64_t min_weight;
 };
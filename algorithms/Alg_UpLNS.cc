@@ -0,0 +1,308 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#include "Alg_UpLNS.h"
+#include "../Portfolio.h"
+
+#include <stdlib.h>
+
+using namespace upmax;
+
+/*_________________________________________________________________________________________________
+  |
+  |  improve : (freed : vec<int>&)  ->  [bool]
+  |
+  |  Description:
+  |
+  |    Fixes every variable outside the partitions in 'freed' to its value in
+  |    the best model and assumes that the soft clauses of these partitions,
+  |    and the ones satisfied by the best model, are satisfied. While this is
+  |    unsatisfiable, the lightest soft clause of the core is no longer
+  |    assumed, preferring the ones falsified by the best model. The search
+  |    gives up when the conflict limit is reached or when the soft clauses
+  |    given up already outweigh the possible improvement.
+  |
+  |  Pre-conditions:
+  |    * 'model' is not empty.
+  |
+  |  Post-conditions:
+  |    * 'model' and 'ubCost' are updated if a cheaper model is found.
+  |
+  |________________________________________________________________________________________________@*/
+bool UpLNS::improve(vec<int> &freed) {
+  for (int i = 0; i < freeVar.size(); i++)
+    freeVar[i] = false;
+  for (int i = 0; i < freeSoft.size(); i++)
+    freeSoft[i] = false;
+  for (int i = 0; i < freed.size(); i++) {
+    for (int j = 0; j < partition_vars[freed[i]].size(); j++)
+      freeVar[partition_vars[freed[i]][j]] = true;
+    for (int j = 0; j < soft_partitions[freed[i]].size(); j++)
+      freeSoft[soft_partitions[freed[i]][j]] = true;
+  }
+
+  vec<Lit> fixed;
+  for (int i = 0; i < model.size(); i++)
+    if (!freeVar[i])
+      fixed.push(model[i] == l_True ? mkLit(i) : ~mkLit(i));
+
+  // Soft clauses falsified by the best model outside the neighbourhood are
+  // not assumed; they are expected to remain falsified.
+  vec<bool> satisfied;
+  vec<bool> assumed;
+  satisfied.growTo(maxsat_formula->nSoft(), false);
+  assumed.growTo(maxsat_formula->nSoft(), false);
+  uint64_t fixedCost = 0;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    for (int j = 0; !satisfied[i] && j < getSoftClause(i).clause.size(); j++) {
+      Lit l = getSoftClause(i).clause[j];
+      if ((model[var(l)] == l_True) != sign(l))
+        satisfied[i] = true;
+    }
+    assumed[i] = satisfied[i] || freeSoft[i];
+    if (!assumed[i])
+      fixedCost += getSoftClause(i).weight;
+  }
+
+  uint64_t dropped = 0;
+  vec<Lit> assumptions;
+  solver->setConfBudget(_limit);
+  for (;;) {
+    assumptions.clear();
+    fixed.copyTo(assumptions);
+    for (int i = 0; i < maxsat_formula->nSoft(); i++)
+      if (assumed[i])
+        assumptions.push(~getAssumptionLit(i));
+
+    lbool res = searchSATSolver(solver, assumptions);
+    if (res == l_Undef)
+      break;
+
+    if (res == l_True) {
+      uint64_t newCost = computeCostModel(solver->model);
+      if (newCost >= ubCost)
+        break;
+      nbSatisfiable++;
+      saveModel(solver->model);
+      printBound(newCost);
+      ubCost = newCost;
+      solver->budgetOff();
+      return true;
+    }
+
+    nbCores++;
+    // Soft clauses falsified by the best model are given up first.
+    int lightest = -1;
+    for (int i = 0; i < solver->conflict.size(); i++) {
+      int index_soft = softIndex(solver->conflict[i]);
+      if (index_soft == -1)
+        continue;
+      if (lightest == -1 ||
+          (satisfied[lightest] && !satisfied[index_soft]) ||
+          (satisfied[lightest] == satisfied[index_soft] &&
+           getSoftClause(index_soft).weight < getSoftClause(lightest).weight))
+        lightest = index_soft;
+    }
+
+    // The fixed variables alone are inconsistent with the hard clauses.
+    if (lightest == -1)
+      break;
+
+    assumed[lightest] = false;
+    dropped += getSoftClause(lightest).weight;
+    if (fixedCost + dropped >= ubCost)
+      break;
+  }
+
+  solver->budgetOff();
+  return false;
+}
+
+// Picks '_size' distinct partitions at random.
+void UpLNS::pickNeighbourhood(vec<int> &freed) {
+  freed.clear();
+  int n = soft_partitions.size();
+  while (freed.size() < _size) {
+    int p = rand_r(&_seed) % n;
+    bool picked = false;
+    for (int i = 0; i < freed.size() && !picked; i++)
+      picked = freed[i] == p;
+    if (!picked)
+      freed.push(p);
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  search : [void] ->  [void]
+  |
+  |  Description:
+  |
+  |    Finds a model of the hard clauses and improves it one neighbourhood at
+  |    a time. After as many failed neighbourhoods as there are partitions,
+  |    the neighbourhoods grow by one partition, or the conflict limit is
+  |    doubled once they cover the whole formula. Since no lower bound is
+  |    computed, the search only stops if the hard clauses are unsatisfiable,
+  |    a model of cost 0 is found, or it is interrupted.
+  |
+  |  Post-conditions:
+  |    * 'ubCost' is updated.
+  |    * 'nbSatisfiable' is updated.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode UpLNS::search() {
+  printConfiguration();
+
+  initRelaxation();
+  solver = rebuildSolver();
+  initNeighbourhoods();
+
+  lbool res = searchSATSolver(solver);
+  if (res == l_False) {
+    printAnswer(_UNSATISFIABLE_);
+    return _UNSATISFIABLE_;
+  }
+  assert(res == l_True);
+  nbSatisfiable++;
+  ubCost = computeCostModel(solver->model);
+  saveModel(solver->model);
+  printBound(ubCost);
+
+  vec<int> freed;
+  int failed = 0;
+  while (ubCost > 0) {
+    // Continue from the best model of the other solvers of the portfolio.
+    if (portfolio != NULL && portfolio->importModel(model, ubCost)) {
+      ubCost = computeCostModel(model);
+      failed = 0;
+    }
+
+    pickNeighbourhood(freed);
+    if (improve(freed)) {
+      failed = 0;
+      continue;
+    }
+
+    if (++failed < soft_partitions.size())
+      continue;
+    failed = 0;
+    if (_size < soft_partitions.size())
+      _size++;
+    else if (_limit < INT32_MAX / 2)
+      _limit *= 2;
+  }
+
+  printAnswer(_OPTIMUM_);
+  return _OPTIMUM_;
+}
+
+// Collects the variables of the soft clauses of each partition and of the
+// hard clauses with the same partition label.
+void UpLNS::initNeighbourhoods() {
+  PartitionSchedule schedule(maxsat_formula, partition_order);
+  schedule.build(soft_partitions);
+
+  vec<int> labelPartition;
+  for (int p = 0; p < soft_partitions.size(); p++) {
+    int label = getSoftClause(soft_partitions[p][0]).getPartition();
+    if (label >= 0) {
+      labelPartition.growTo(label + 1, -1);
+      labelPartition[label] = p;
+    }
+  }
+
+  vec<int> seen;
+  seen.growTo(maxsat_formula->nInitialVars(), -1);
+  partition_vars.growTo(soft_partitions.size());
+  for (int p = 0; p < soft_partitions.size(); p++) {
+    for (int i = 0; i < soft_partitions[p].size(); i++) {
+      vec<Lit> &c = getSoftClause(soft_partitions[p][i]).clause;
+      for (int j = 0; j < c.size(); j++)
+        if (seen[var(c[j])] != p) {
+          seen[var(c[j])] = p;
+          partition_vars[p].push(var(c[j]));
+        }
+    }
+  }
+
+  for (int i = 0; i < maxsat_formula->nHard(); i++) {
+    int label = getHardClause(i).getPartition();
+    if (label < 0 || label >= labelPartition.size() ||
+        labelPartition[label] == -1)
+      continue;
+    int p = labelPartition[label];
+    vec<Lit> &c = getHardClause(i).clause;
+    for (int j = 0; j < c.size(); j++)
+      if (seen[var(c[j])] != p) {
+        seen[var(c[j])] = p;
+        partition_vars[p].push(var(c[j]));
+      }
+  }
+
+  freeVar.growTo(maxsat_formula->nInitialVars(), false);
+  freeSoft.growTo(maxsat_formula->nSoft(), false);
+}
+
+// Rebuilds the SAT solver with the hard clauses and the relaxed soft clauses.
+Solver *UpLNS::rebuildSolver() {
+
+  Solver *S = newSATSolver();
+
+  reserveSATVariables(S, maxsat_formula->nVars());
+
+  for (int i = 0; i < maxsat_formula->nVars(); i++)
+    newSATVariable(S);
+
+  for (int i = 0; i < maxsat_formula->nHard(); i++)
+    S->addClause(getHardClause(i).clause);
+
+  vec<Lit> clause;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    clause.clear();
+    Soft &s = getSoftClause(i);
+    s.clause.copyTo(clause);
+    for (int j = 0; j < s.relaxation_vars.size(); j++)
+      clause.push(s.relaxation_vars[j]);
+
+    S->addClause(clause);
+  }
+
+  return S;
+}
+
+// Relaxes each soft clause with a fresh variable, which is also its
+// assumption literal.
+void UpLNS::initRelaxation() {
+  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+    Lit l = maxsat_formula->newLiteral();
+    Soft &s = getSoftClause(i);
+    s.relaxation_vars.push(l);
+    s.assumption_var = l;
+    setCoreMapping(l, i);
+  }
+}
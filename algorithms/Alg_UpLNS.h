@@ -0,0 +1,110 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+#ifndef Alg_UpLNS_h
+#define Alg_UpLNS_h
+
+#ifdef SIMP
+#include "simp/SimpSolver.h"
+#else
+#include "core/Solver.h"
+#endif
+
+#include "../MaxSAT.h"
+#include "../PartitionSchedule.h"
+
+namespace upmax {
+
+//=================================================================================================
+// Large neighbourhood search over the user partitions. Starting from the best
+// model (of any solver of the portfolio), the variables of a few partitions
+// are freed while all other variables are fixed through assumptions, and the
+// soft clauses are greedily satisfied within a conflict limit. This only
+// finds upper bounds, so it is meant to run in a portfolio next to a
+// core-guided algorithm.
+class UpLNS : public MaxSAT {
+
+public:
+  UpLNS(int verb = _VERBOSITY_MINIMAL_, int limit = 1000) {
+    solver = NULL;
+    verbosity = verb;
+    _limit = limit;
+    _size = 1;
+    _seed = 1;
+  }
+  ~UpLNS() {
+    if (solver != NULL)
+      delete solver;
+  }
+
+  StatusCode search(); // LNS search (only stops when interrupted).
+
+  // Print solver configuration.
+  void printConfiguration() {
+
+    if (!print)
+      return;
+
+    printf("c ==========================================[ Solver Settings "
+           "]============================================\n");
+    printf("c |                                                                "
+           "                                       |\n");
+    printf("c |  Algorithm: %23s                                             "
+           "                      |\n",
+           "UpLNS");
+    printf("c |  Conflict limit: %18d                                        "
+           "                           |\n",
+           _limit);
+    printf("c |                                                                "
+           "                                       |\n");
+  }
+
+protected:
+  Solver *rebuildSolver(); // Rebuild MaxSAT solver.
+  void initRelaxation();   // Relaxes each soft clause.
+  void initNeighbourhoods(); // Collects the variables of each partition.
+
+  // Frees the variables of the partitions in 'freed' and tries to find a
+  // model with a smaller cost. Returns true if 'model' was improved.
+  bool improve(vec<int> &freed);
+  void pickNeighbourhood(vec<int> &freed);
+
+  Solver *solver; // SAT solver used as a black box.
+
+  vec<vec<int>> soft_partitions; // Soft clauses of each partition.
+  vec<vec<int>> partition_vars;  // Variables of each partition.
+  vec<bool> freeVar;             // Variables of the current neighbourhood.
+  vec<bool> freeSoft;            // Soft clauses of the current neighbourhood.
+
+  int _limit;        // Conflict limit of each neighbourhood.
+  int _size;         // Number of partitions of each neighbourhood.
+  unsigned _seed;    // Seed for picking neighbourhoods.
+};
+} // namespace upmax
+
+#endif
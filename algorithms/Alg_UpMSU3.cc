@@ -72,38 +72,61 @@ StatusCode UpMSU3::MSU3_iterative() {
   lbool res = l_True;
   initRelaxation();
   solver = rebuildSolver();
-  vec<Lit> assumptions;
+  AssumptionSet assumptions;
   vec<Lit> joinObjFunction;
   vec<Lit> currentObjFunction;
   vec<Lit> encodingAssumptions;
   encoder.setIncremental(_INCREMENTAL_ITERATIVE_);
 
   activeSoft.growTo(maxsat_formula->nSoft(), false);
-  for (int i = 0; i < maxsat_formula->nSoft(); i++)
-    coreMapping[getAssumptionLit(i)] = i;
 
   int current_partition = 0;
   vec<bool> activeSoftPartition;
   activeSoftPartition.growTo(maxsat_formula->nSoft(), false);
   _partitions = soft_partitions.size();
   
-  printf("c #Soft Partitions = %d\n",_partitions);
-  printf("c Partition #%d= %d\n",current_partition+1,soft_partitions[current_partition].size());
+  if (print)
+    printf("c #Soft Partitions = %d\n",_partitions);
+
+  partitionCores.clear();
+  if (_threads > 0) {
+    vec<Solver *> solvers;
+    for (int i = 0; i < std::min(_threads, _partitions); i++)
+      solvers.push(rebuildSolver());
+    StatusCode status =
+        extractPartitionCores(solvers, soft_partitions, _limit);
+    if (status != _UNKNOWN_)
+      return status;
+  }
+
+  if (print)
+    printf("c Partition #%d= %d\n",current_partition+1,soft_partitions[current_partition].size());
 
-   for (int i = 0; i < soft_partitions[current_partition].size(); i++){
+  if (partitionCores.size() > 0) {
+    relaxPartitionCores(current_partition, currentObjFunction,
+                        encodingAssumptions);
+    assumptions.setTail(encodingAssumptions);
+  }
+
+  for (int i = 0; i < soft_partitions[current_partition].size(); i++){
     activeSoftPartition[soft_partitions[current_partition][i]] = true;
-    assumptions.push(~maxsat_formula->getSoftClause(soft_partitions[current_partition][i]).assumption_var);
-   }
+    if (!activeSoft[soft_partitions[current_partition][i]])
+      assumptions.add(~maxsat_formula->getSoftClause(soft_partitions[current_partition][i]).assumption_var);
+  }
 
   // TODO: check if the hard clauses are satisfiable
 
   for (;;) {
 
+    if (switchToLinearSearch(current_partition))
+      return linearSearch(currentObjFunction, encodingAssumptions);
+
     if (_limit != -1 && current_partition+1 != _partitions)
-      solver->setConfBudget(_limit);
+      conflict_budget.start(solver, current_partition);
     else
       solver->budgetOff();
-    res = searchSATSolver(solver, assumptions);
+    res = searchSATSolver(solver, assumptions.lits());
+    conflict_budget.finish(solver, res);
     if (res != l_False) {
 
       current_partition++;
@@ -116,6 +139,7 @@ StatusCode UpMSU3::MSU3_iterative() {
           printBound(newCost);
           ubCost = newCost;
         }
+        improveModel(solver);
 
         if (ubCost == 0){
           printAnswer(_OPTIMUM_);
@@ -128,15 +152,25 @@ StatusCode UpMSU3::MSU3_iterative() {
         return _OPTIMUM_; 
       } else {
 
-        printf("c Partition #%d= %d\n",current_partition+1,soft_partitions[current_partition].size());
+        if (print)
+          printf("c Partition #%d= %d\n",current_partition+1,soft_partitions[current_partition].size());
+
+        if (partitionCores.size() > 0) {
+          relaxPartitionCores(current_partition, currentObjFunction,
+                              encodingAssumptions);
+          assumptions.setTail(encodingAssumptions);
+        }
 
         for (int i = 0; i < soft_partitions[current_partition].size(); i++){
           activeSoftPartition[soft_partitions[current_partition][i]] = true;
-          assumptions.push(~maxsat_formula->getSoftClause(soft_partitions[current_partition][i]).assumption_var);
+          // Soft clauses of partition cores are already relaxed.
+          if (!activeSoft[soft_partitions[current_partition][i]])
+            assumptions.add(~maxsat_formula->getSoftClause(soft_partitions[current_partition][i]).assumption_var);
         }
 
       }
     } else {
+      minimizeCore(solver, solver->conflict);
       lbCost++;
       nbCores++;
       if (verbosity > 0)
@@ -149,25 +183,19 @@ StatusCode UpMSU3::MSU3_iterative() {
         return _UNSATISFIABLE_;
       }
 
+      // Only the soft clauses of the core are removed from the assumptions.
       joinObjFunction.clear();
       for (int i = 0; i < solver->conflict.size(); i++) {
-        if (coreMapping.find(solver->conflict[i]) != coreMapping.end()) {
-          assert(!activeSoft[coreMapping[solver->conflict[i]]]);
-          activeSoft[coreMapping[solver->conflict[i]]] = true;
-          joinObjFunction.push(
-              getRelaxationLit(coreMapping[solver->conflict[i]]));
+        int index_soft = softIndex(solver->conflict[i]);
+        if (index_soft != -1) {
+          assert(!activeSoft[index_soft]);
+          activeSoft[index_soft] = true;
+          assumptions.remove(~getAssumptionLit(index_soft));
+          joinObjFunction.push(getRelaxationLit(index_soft));
+          currentObjFunction.push(getRelaxationLit(index_soft));
         }
       }
 
-      currentObjFunction.clear();
-      assumptions.clear();
-      for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-        if (activeSoft[i])
-          currentObjFunction.push(getRelaxationLit(i));
-        else if (!activeSoft[i] && activeSoftPartition[i])
-          assumptions.push(~getAssumptionLit(i));
-      }
-
       if (verbosity > 0)
         printf("c Relaxed soft clauses %d / %d\n", currentObjFunction.size(),
                objFunction.size());
@@ -189,19 +217,625 @@ StatusCode UpMSU3::MSU3_iterative() {
                                      encodingAssumptions);
       }
 
+      assumptions.setTail(encodingAssumptions);
+    }
+  }
+  return _ERROR_;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  MSU3_bmo : [void] ->  [StatusCode]
+  |
+  |  Description:
+  |
+  |    Lexicographic search for weighted formulas where each weight exceeds
+  |    the sum of all lighter weights (see 'isBMO'). The weight levels are
+  |    solved from the heaviest to the lightest, each one as an unweighted
+  |    formula with its own totalizer. The partitions are restricted to the
+  |    soft clauses of the level and activated one at a time as in
+  |    'MSU3_iterative'. Once all partitions of a level are satisfiable, its
+  |    assumptions are hardened such that the lighter levels cannot change
+  |    its optimum.
+  |
+  |  Pre-conditions:
+  |    * 'orderWeights' holds the weights of the levels, heaviest first.
+  |
+  |  Post-conditions:
+  |    * 'ubCost' is updated.
+  |    * 'lbCost' is updated.
+  |    * 'nbSatisfiable' is updated.
+  |    * 'nbCores' is updated.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode UpMSU3::MSU3_bmo() {
+
+  assert(orderWeights.size() > 0);
+
+  lbool res = l_True;
+  initRelaxation();
+  solver = rebuildSolver();
+  activeSoft.growTo(maxsat_formula->nSoft(), false);
+
+  PartitionSchedule schedule(maxsat_formula, partition_order);
+  vec<vec<int>> partitions;
+  soft_partitions.moveTo(partitions);
+
+  for (int level = 0; level < (int)orderWeights.size(); level++) {
+    uint64_t weight = orderWeights[level];
+    schedule.buildLevel(partitions, weight, soft_partitions);
+    _partitions = soft_partitions.size();
+    if (print) {
+      printf("c Level #%d weight = %" PRIu64 "\n", level + 1, weight);
+      printf("c #Soft Partitions = %d\n", _partitions);
+    }
+
+    Encoder level_encoder(_INCREMENTAL_ITERATIVE_, _CARD_TOTALIZER_);
+    AssumptionSet assumptions;
+    vec<Lit> joinObjFunction;
+    vec<Lit> currentObjFunction;
+    vec<Lit> encodingAssumptions;
+    uint64_t levelCost = 0;
+
+    int current_partition = 0;
+    while (current_partition < _partitions) {
+      if (print)
+        printf("c Partition #%d= %d\n", current_partition + 1,
+               soft_partitions[current_partition].size());
+      vec<int> &softs = soft_partitions[current_partition];
+      for (int i = 0; i < softs.size(); i++)
+        assumptions.add(~getAssumptionLit(softs[i]));
+
+      for (;;) {
+        if (_limit != -1 && current_partition + 1 != _partitions)
+          conflict_budget.start(solver, current_partition);
+        else
+          solver->budgetOff();
+        res = searchSATSolver(solver, assumptions.lits());
+        conflict_budget.finish(solver, res);
+        if (res != l_False)
+          break;
+
+        minimizeCore(solver, solver->conflict);
+        if (solver->conflict.size() == 0) {
+          printAnswer(_UNSATISFIABLE_);
+          return _UNSATISFIABLE_;
+        }
+
+        levelCost++;
+        lbCost += weight;
+        nbCores++;
+        sumSizeCores += solver->conflict.size();
+        if (verbosity > 0)
+          printf("c LB : %-12" PRIu64 "\n", lbCost);
+
+        joinObjFunction.clear();
+        for (int i = 0; i < solver->conflict.size(); i++) {
+          int index_soft = softIndex(solver->conflict[i]);
+          if (index_soft != -1) {
+            assert(!activeSoft[index_soft]);
+            activeSoft[index_soft] = true;
+            assumptions.remove(~getAssumptionLit(index_soft));
+            joinObjFunction.push(getRelaxationLit(index_soft));
+            currentObjFunction.push(getRelaxationLit(index_soft));
+          }
+        }
+
+        if (!level_encoder.hasCardEncoding()) {
+          if (levelCost != (unsigned)currentObjFunction.size()) {
+            level_encoder.buildCardinality(solver, currentObjFunction,
+                                           levelCost);
+            level_encoder.incUpdateCardinality(solver, currentObjFunction,
+                                               levelCost, encodingAssumptions);
+          }
+        } else {
+          if (joinObjFunction.size() > 0)
+            level_encoder.joinEncoding(solver, joinObjFunction, levelCost);
+          level_encoder.incUpdateCardinality(solver, currentObjFunction,
+                                             levelCost, encodingAssumptions);
+        }
+        assumptions.setTail(encodingAssumptions);
+      }
+
+      if (res == l_True) {
+        nbSatisfiable++;
+        uint64_t newCost = computeCostModel(solver->model);
+        if (newCost <= ubCost) {
+          saveModel(solver->model);
+          printBound(newCost);
+          ubCost = newCost;
+        }
+        improveModel(solver);
+
+        if (ubCost == 0) {
+          printAnswer(_OPTIMUM_);
+          return _OPTIMUM_;
+        }
+      }
+      current_partition++;
+    }
+
+    // The last call of the level has no conflict limit, so its optimum is
+    // 'levelCost'.
+    hardenLevel(solver, assumptions.lits());
+  }
+
+  printAnswer(_OPTIMUM_);
+  return _OPTIMUM_;
+}
+
+// Core-guided search stops once all partitions are active or after '_lsu'
+// seconds, as long as there is a model to start from.
+bool UpMSU3::switchToLinearSearch(int current_partition) {
+  if (_lsu == -1 || model.size() == 0)
+    return false;
+  return current_partition + 1 >= _partitions ||
+         (_lsu > 0 && cpuTime() - initialTime >= _lsu);
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  linearSearch : (currentObjFunction : vec<Lit>&)
+  |                 (encodingAssumptions : vec<Lit>&) ->  [StatusCode]
+  |
+  |  Description:
+  |
+  |    SAT-UNSAT linear search that finishes the core-guided search. All soft
+  |    clauses that are not relaxed yet are joined to the totalizer of the
+  |    cores, and its right-hand side is decreased to one less than the cost
+  |    of the best model until the formula is unsatisfiable or the cost meets
+  |    the lower bound of the cores found so far.
+  |
+  |  Pre-conditions:
+  |    * 'model' is not empty.
+  |    * 'currentObjFunction' and 'encodingAssumptions' are the ones of
+  |      'MSU3_iterative'.
+  |
+  |  Post-conditions:
+  |    * 'ubCost' is updated.
+  |    * 'nbSatisfiable' is updated.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode UpMSU3::linearSearch(vec<Lit> &currentObjFunction,
+                                vec<Lit> &encodingAssumptions) {
+  if (verbosity > 0)
+    printf("c Linear search: LB %" PRIu64 " / UB %" PRIu64 "\n", lbCost,
+           ubCost);
+
+  vec<Lit> joinObjFunction;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    if (!activeSoft[i]) {
+      activeSoft[i] = true;
+      joinObjFunction.push(getRelaxationLit(i));
+      currentObjFunction.push(getRelaxationLit(i));
+    }
+
+  solver->budgetOff();
+  while (ubCost > lbCost) {
+    int64_t rhs = ubCost - 1;
+    if (!encoder.hasCardEncoding()) {
+      encoder.buildCardinality(solver, currentObjFunction, rhs);
+      if (encoder.hasCardEncoding())
+        encoder.incUpdateCardinality(solver, currentObjFunction, rhs,
+                                     encodingAssumptions);
+    } else {
+      if (joinObjFunction.size() > 0)
+        encoder.joinEncoding(solver, joinObjFunction, lbCost);
+      encoder.incUpdateCardinality(solver, currentObjFunction, rhs,
+                                   encodingAssumptions);
+    }
+    joinObjFunction.clear();
+
+    lbool res = searchSATSolver(solver, encodingAssumptions);
+    if (res == l_False)
+      break;
+    assert(res == l_True);
+
+    nbSatisfiable++;
+    uint64_t newCost = computeCostModel(solver->model);
+    assert(newCost < ubCost);
+    saveModel(solver->model);
+    printBound(newCost);
+    ubCost = newCost;
+    improveModel(solver);
+  }
+
+  printAnswer(_OPTIMUM_);
+  return _OPTIMUM_;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  MSU3_tree : [void] ->  [void]
+  |
+  |  Description:
+  |
+  |    Hierarchical merge of partitions for the MSU3 algorithm.
+  |    Each partition is a leaf of a merge tree and is first solved on its
+  |    own, i.e. only its soft clauses and the cardinality constraint over its
+  |    relaxed soft clauses are assumed. Once two nodes are saturated, they
+  |    are merged into a parent node (see 'mergeNodes'), whose lower bound is
+  |    the sum of the lower bounds of its children and whose totalizer is
+  |    built on top of the ones of its children. Hence, the cores found in
+  |    the children do not have to be found again. The root of the tree
+  |    contains all partitions and, when saturated, yields an optimal
+  |    solution.
+  |
+  |  Pre-conditions:
+  |    * Assumes Totalizer is used as the cardinality encoding.
+  |
+  |  Post-conditions:
+  |    * 'ubCost' is updated.
+  |    * 'nbSatisfiable' is updated.
+  |    * 'nbCores' is updated.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode UpMSU3::MSU3_tree() {
+
+  if (encoding != _CARD_TOTALIZER_) {
+    if(print) {
+      printf("Error: Currently algorithm MSU3 with iterative encoding only "
+             "supports the totalizer encoding.\n");
+      printf("s UNKNOWN\n");
+    }
+    throw MaxSATException(__FILE__, __LINE__, "MSU3 only supports totalizer");
+    return _UNKNOWN_;
+  }
+
+  initRelaxation();
+  solver = rebuildSolver();
+
+  activeSoft.growTo(maxsat_formula->nSoft(), false);
+
+  _partitions = soft_partitions.size();
+  if (print)
+    printf("c #Soft Partitions = %d\n", _partitions);
+
+  vec<TreeNode *> nodes;     // All nodes of the merge tree.
+  vec<TreeNode *> saturated; // Saturated nodes that are not merged yet.
+  for (int i = 0; i < _partitions; i++) {
+    TreeNode *leaf = new TreeNode();
+    leaf->addPartition(i);
+    nodes.push(leaf);
+  }
+  if (_partitions == 0)
+    nodes.push(new TreeNode());
+
+  int leaves = nodes.size();
+  int next = 0;
+  StatusCode res = _UNKNOWN_;
+  for (;;) {
+    TreeNode *node = NULL;
+    if (next < leaves)
+      node = nodes[next++];
+    else {
+      node = mergeNodes(saturated);
+      nodes.push(node);
+    }
+    bool root = next == leaves && saturated.size() == 0;
+
+    if (verbosity > 0)
+      printf("c Node: %d partitions / %d soft / LB %" PRId64 "\n",
+             node->getPartitions().size(), nodeSoft(node),
+             node->getLowerBound());
+
+    res = solveNode(node, root);
+    // A saturated root is an optimal solution.
+    if (root && res == _SATISFIABLE_)
+      res = _OPTIMUM_;
+    if (root || res == _OPTIMUM_ || res == _UNSATISFIABLE_)
+      break;
+
+    saturated.push(node);
+  }
+
+  for (int i = 0; i < nodes.size(); i++) {
+    if (nodes[i]->hasEncoder())
+      delete nodes[i]->getEncoder();
+    if (nodes[i]->hasEncodingAssumptions())
+      delete nodes[i]->getEncodingAssumptions();
+    delete nodes[i];
+  }
+
+  printAnswer(res);
+  return res;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  solveNode : (node : TreeNode *) (root : bool) ->  [StatusCode]
+  |
+  |  Description:
+  |
+  |    Runs MSU3 on the soft clauses of a node of the merge tree until it is
+  |    saturated. Each core increments the lower bound of the node and of the
+  |    formula, and the totalizer of the node is extended with the soft
+  |    clauses of the core. The conflict limit only applies to inner nodes.
+  |
+  |  Post-conditions:
+  |    * Returns _SATISFIABLE_ if the node is saturated, _UNKNOWN_ if the
+  |      conflict limit was reached, and _OPTIMUM_ or _UNSATISFIABLE_ if the
+  |      formula was solved.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode UpMSU3::solveNode(TreeNode *node, bool root) {
+
+  vec<Lit> assumptions;
+  vec<Lit> joinObjFunction;
+  vec<int> &parts = node->getPartitions();
+
+  for (;;) {
+    assumptions.clear();
+    for (int i = 0; i < parts.size(); i++) {
+      for (int j = 0; j < soft_partitions[parts[i]].size(); j++) {
+        int s = soft_partitions[parts[i]][j];
+        if (!activeSoft[s])
+          assumptions.push(~getAssumptionLit(s));
+      }
+    }
+    if (node->hasEncodingAssumptions()) {
+      vec<Lit> &encodingAssumptions = *node->getEncodingAssumptions();
       for (int i = 0; i < encodingAssumptions.size(); i++)
         assumptions.push(encodingAssumptions[i]);
     }
+
+    if (_limit != -1 && !root)
+      conflict_budget.start(solver, parts[0]);
+    else
+      solver->budgetOff();
+    lbool res = searchSATSolver(solver, assumptions);
+    conflict_budget.finish(solver, res);
+
+    if (res == l_True) {
+      nbSatisfiable++;
+      uint64_t newCost = computeCostModel(solver->model);
+      if (newCost <= ubCost) {
+        saveModel(solver->model);
+        printBound(newCost);
+        ubCost = newCost;
+      }
+      improveModel(solver);
+
+      if (ubCost == lbCost)
+        return _OPTIMUM_;
+      return _SATISFIABLE_;
+    } else if (res == l_Undef)
+      return _UNKNOWN_;
+
+    minimizeCore(solver, solver->conflict);
+    lbCost++;
+    nbCores++;
+    node->incrementLowerBound();
+    if (verbosity > 0)
+      printf("c LB : %-12" PRIu64 "\n", lbCost);
+
+    sumSizeCores += solver->conflict.size();
+
+    if (solver->conflict.size() == 0)
+      return _UNSATISFIABLE_;
+
+    joinObjFunction.clear();
+    for (int i = 0; i < solver->conflict.size(); i++) {
+      int index_soft = softIndex(solver->conflict[i]);
+      if (index_soft != -1) {
+        assert(!activeSoft[index_soft]);
+        activeSoft[index_soft] = true;
+        joinObjFunction.push(
+            getRelaxationLit(index_soft));
+      }
+    }
+
+    updateNodeEncoding(node, joinObjFunction);
   }
   return _ERROR_;
 }
 
-// Public search method
+/*_________________________________________________________________________________________________
+  |
+  |  updateNodeEncoding : (node : TreeNode *) (join : vec<Lit>&) ->  [void]
+  |
+  |  Description:
+  |
+  |    Extends the totalizer of a node with the relaxation literals in 'join'
+  |    and restricts its right-hand side to the lower bound of the node.
+  |
+  |________________________________________________________________________________________________@*/
+void UpMSU3::updateNodeEncoding(TreeNode *node, vec<Lit> &join) {
+
+  vec<Lit> currentObjFunction;
+  nodeObjFunction(node, currentObjFunction);
+
+  if (!node->hasEncoder()) {
+    node->setEncoder(new Encoder(_INCREMENTAL_ITERATIVE_, _CARD_TOTALIZER_));
+    node->setEncodingAssumptions(new vec<Lit>());
+  }
+
+  Encoder *enc = node->getEncoder();
+  int64_t lb = node->getLowerBound();
+  if (!enc->hasCardEncoding()) {
+    if (lb != currentObjFunction.size()) {
+      enc->buildCardinality(solver, currentObjFunction, lb);
+      enc->incUpdateCardinality(solver, currentObjFunction, lb,
+                                *node->getEncodingAssumptions());
+    }
+  } else {
+    if (join.size() > 0)
+      enc->joinEncoding(solver, join, lb);
+    enc->incUpdateCardinality(solver, currentObjFunction, lb,
+                              *node->getEncodingAssumptions());
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  mergeNodes : (saturated : vec<TreeNode *>&) ->  [TreeNode *]
+  |
+  |  Description:
+  |
+  |    Removes two saturated nodes from 'saturated' and returns their parent.
+  |    The pair is selected with the merge heuristic:
+  |      * _SIZE_: the two nodes with fewer soft clauses;
+  |      * _CORES_: the two nodes with more cores (higher lower bound);
+  |      * _SATURATION_ONLY_: the two nodes that were saturated first.
+  |    The totalizer of the parent reuses the totalizers of its children.
+  |
+  |________________________________________________________________________________________________@*/
+TreeNode *UpMSU3::mergeNodes(vec<TreeNode *> &saturated) {
+  assert(saturated.size() > 1);
+
+  int first = 0;
+  int second = 1;
+  if (_mode != _SATURATION_ONLY_) {
+    std::vector<std::pair<int64_t, int> > order;
+    for (int i = 0; i < saturated.size(); i++) {
+      int64_t key = nodeSoft(saturated[i]);
+      if (_mode == _CORES_)
+        key = -saturated[i]->getLowerBound();
+      order.push_back(std::make_pair(key, i));
+    }
+    std::sort(order.begin(), order.end());
+    first = std::min(order[0].second, order[1].second);
+    second = std::max(order[0].second, order[1].second);
+  }
+
+  TreeNode *left = saturated[first];
+  TreeNode *right = saturated[second];
+  for (int i = second; i < saturated.size() - 1; i++)
+    saturated[i] = saturated[i + 1];
+  saturated.pop();
+  for (int i = first; i < saturated.size() - 1; i++)
+    saturated[i] = saturated[i + 1];
+  saturated.pop();
+
+  // The child that owns a totalizer is kept on the left.
+  if (!left->hasEncoder() || !left->getEncoder()->hasCardEncoding()) {
+    TreeNode *tmp = left;
+    left = right;
+    right = tmp;
+  }
+
+  TreeNode *node = new TreeNode();
+  node->addPartitions(left->getPartitions());
+  node->addPartitions(right->getPartitions());
+  node->incrementLowerBound(left->getLowerBound() + right->getLowerBound());
+  left->setParent(node);
+  right->setParent(node);
+
+  node->setEncoder(left->getEncoder());
+  node->setEncodingAssumptions(left->getEncodingAssumptions());
+  left->setEncoder(NULL);
+  left->setEncodingAssumptions(NULL);
+
+  if (node->hasEncoder() && node->getEncoder()->hasCardEncoding()) {
+    Encoder *enc = node->getEncoder();
+    if (right->hasEncoder() && right->getEncoder()->hasCardEncoding())
+      enc->addCardinality(solver, *right->getEncoder(), node->getLowerBound());
+    else {
+      // The right child has no totalizer since its lower bound is the
+      // number of its relaxed soft clauses.
+      vec<Lit> join;
+      nodeObjFunction(right, join);
+      if (join.size() > 0)
+        enc->joinEncoding(solver, join, node->getLowerBound());
+    }
+
+    vec<Lit> currentObjFunction;
+    nodeObjFunction(node, currentObjFunction);
+    enc->incUpdateCardinality(solver, currentObjFunction, node->getLowerBound(),
+                              *node->getEncodingAssumptions());
+  }
+
+  if (right->hasEncoder()) {
+    delete right->getEncoder();
+    right->setEncoder(NULL);
+  }
+  if (right->hasEncodingAssumptions()) {
+    delete right->getEncodingAssumptions();
+    right->setEncodingAssumptions(NULL);
+  }
+
+  return node;
+}
+
+// Relaxation literals of the soft clauses of a node that were found in cores.
+void UpMSU3::nodeObjFunction(TreeNode *node, vec<Lit> &lits) {
+  vec<int> &parts = node->getPartitions();
+  for (int i = 0; i < parts.size(); i++) {
+    for (int j = 0; j < soft_partitions[parts[i]].size(); j++) {
+      int s = soft_partitions[parts[i]][j];
+      if (activeSoft[s])
+        lits.push(getRelaxationLit(s));
+    }
+  }
+}
+
+// Number of soft clauses of a node.
+int UpMSU3::nodeSoft(TreeNode *node) {
+  int n = 0;
+  vec<int> &parts = node->getPartitions();
+  for (int i = 0; i < parts.size(); i++)
+    n += soft_partitions[parts[i]].size();
+  return n;
+}
+
+// Relaxes the soft clauses of the cores of partition 'k' and updates the
+// cardinality constraint with one more unit of lower bound for each core.
+void UpMSU3::relaxPartitionCores(int k, vec<Lit> &currentObjFunction,
+                                 vec<Lit> &encodingAssumptions) {
+  if (partitionCores[k].size() == 0)
+    return;
+
+  vec<Lit> joinObjFunction;
+  for (int i = 0; i < partitionCores[k].size(); i++) {
+    vec<int> &core = partitionCores[k][i];
+    lbCost++;
+    nbCores++;
+    sumSizeCores += core.size();
+    for (int j = 0; j < core.size(); j++) {
+      assert(!activeSoft[core[j]]);
+      activeSoft[core[j]] = true;
+      joinObjFunction.push(getRelaxationLit(core[j]));
+      currentObjFunction.push(getRelaxationLit(core[j]));
+    }
+  }
+
+  if (verbosity > 0)
+    printf("c LB : %-12" PRIu64 "\n", lbCost);
+
+  if (!encoder.hasCardEncoding()) {
+    if (lbCost != (unsigned)currentObjFunction.size()) {
+      encoder.buildCardinality(solver, currentObjFunction, lbCost);
+      encoder.incUpdateCardinality(solver, currentObjFunction, lbCost,
+                                   encodingAssumptions);
+    }
+  } else {
+    encoder.joinEncoding(solver, joinObjFunction, lbCost);
+    encoder.incUpdateCardinality(solver, currentObjFunction, lbCost,
+                                 encodingAssumptions);
+  }
+}
+
 StatusCode UpMSU3::search() {
   
   printConfiguration();
-  createPartitions();
+  PartitionSchedule schedule(maxsat_formula, partition_order);
+  schedule.build(soft_partitions);
+
+  if (maxsat_formula->getProblemType() == _WEIGHTED_) {
+    if (!bmo_search || !isBMO()) {
+      if (print) {
+        printf("c Error: UpMSU3 only supports weighted formulas with "
+               "lexicographic weights.\n");
+        printf("s UNKNOWN\n");
+      }
+      throw MaxSATException(__FILE__, __LINE__,
+                            "UpMSU3 only supports lexicographic weights");
+    }
+    return MSU3_bmo();
+  }
 
+  if (_tree)
+    return MSU3_tree();
   return MSU3_iterative();
 }
 
@@ -320,6 +954,7 @@ void UpMSU3::initRelaxation() {
     Soft &s = getSoftClause(i);
     s.relaxation_vars.push(l);
     s.assumption_var = l;
+    setCoreMapping(l, i);
     objFunction.push(l);
     coeffs.push(s.weight);
   }
@@ -331,39 +966,3 @@ void UpMSU3::print_MSU3_configuration() {
          "                      |\n",
          "UpMSU3");
 }
-
-void UpMSU3::createPartitions() {
-  _partitions = 0;
-
-  for (int i = 0; i < maxsat_formula->nPartitions()+1; i++){
-    soft_partitions_tmp.push();
-    new (&soft_partitions_tmp[i]) vec<int>();
-  }
-
-  for (int i = 0; i < maxsat_formula->nSoft(); i++){
-    int v = maxsat_formula->getSoftClause(i).getPartition();
-    if (v == -1) v = maxsat_formula->nPartitions();
-    assert (v >= 0 && v < soft_partitions_tmp.size());
-    soft_partitions_tmp[v].push(i);
-  }  
-
-  std::vector< pair <int,int> > vect;
-  for (int i = 0; i < soft_partitions_tmp.size(); i++){
-    vect.push_back( std::make_pair(soft_partitions_tmp[i].size(), i) );
-  }
-
-  std::sort(vect.begin(), vect.end());
-  for (int i = 0; i < vect.size(); i++){
-    if (vect[i].first > 0){
-      soft_partitions.push();
-      new (&soft_partitions[soft_partitions.size()-1]) vec<int>();
-      for (int j = 0; j < soft_partitions_tmp[vect[i].second].size(); j++){
-        int v = soft_partitions_tmp[vect[i].second][j];
-        soft_partitions[soft_partitions.size()-1].push(v);
-      }
-      soft_partitions_tmp[vect[i].second].clear();
-    } else soft_partitions_tmp[vect[i].second].clear();
-  }
-  soft_partitions_tmp.clear();
-
-}
\ No newline at end of file
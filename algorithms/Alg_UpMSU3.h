@@ -31,8 +31,11 @@
 
 #include "core/Solver.h"
 
+#include "../AssumptionSet.h"
 #include "../Encoder.h"
+#include "../PartitionSchedule.h"
 #include "../MaxSAT_Partition.h"
+#include "../graph/TreeNode.h"
 #include <algorithm>
 #include <map>
 #include <set>
@@ -43,14 +46,20 @@ namespace upmax {
 class UpMSU3 : public MaxSAT_Partition {
 
 public:
-  UpMSU3(int verb = _VERBOSITY_SOME_, int mode = _SIZE_, int limit = -1) {
+  UpMSU3(int verb = _VERBOSITY_SOME_, int mode = _SIZE_, int limit = -1,
+         bool tree = false, int threads = 0, int lsu = -1) {
   //UpMSU3(int verb = _VERBOSITY_MINIMAL_) {
     solver = NULL;
     verbosity = verb;
     incremental_strategy = _INCREMENTAL_ITERATIVE_;
     encoding = _CARD_TOTALIZER_;
     encoder.setCardEncoding(encoding);
+    _mode = mode;
     _limit = limit;
+    conflict_budget.setLimit(limit);
+    _tree = tree;
+    _threads = threads;
+    _lsu = lsu;
   }
   ~UpMSU3() {
     if (solver != NULL)
@@ -85,7 +94,8 @@ protected:
   StatusCode MSU3_blocking();  // Incremental Blocking MSU3.
   StatusCode MSU3_weakening(); // Incremental Weakening MSU3.
   StatusCode MSU3_iterative(); // Incremental Iterative Encoding MSU3.
-  StatusCode MSU3_bmo(); 
+  StatusCode MSU3_bmo();       // Lexicographic search (weighted).
+  StatusCode MSU3_tree();      // Hierarchical merge of partitions.
 
   // Other
   void initRelaxation(); // Relaxes soft clauses.
@@ -103,9 +113,6 @@ protected:
   vec<int> coeffs; // Coefficients of the literals that are used in the
                    // constraint that excludes models.
 
-  std::map<Lit, int> coreMapping; // Mapping between the assumption literal and
-                                  // the respective soft clause.
-
   // Soft clauses that are currently in the MaxSAT formula.
   vec<bool> activeSoft;
 
@@ -113,11 +120,27 @@ protected:
   int _partitions;
   int _mode;
   int _limit;
+  bool _tree;
+  int _threads; // Workers extracting cores of partitions in parallel.
+  int _lsu; // Seconds before switching to linear search (-1=never, 0=once
+            // all partitions are active).
+
+  bool switchToLinearSearch(int current_partition);
+  StatusCode linearSearch(vec<Lit> &currentObjFunction,
+                          vec<Lit> &encodingAssumptions);
+
+  void relaxPartitionCores(int k, vec<Lit> &currentObjFunction,
+                           vec<Lit> &encodingAssumptions);
+
 
-  void createPartitions();
+  // Merge tree
+  StatusCode solveNode(TreeNode *node, bool root);
+  void updateNodeEncoding(TreeNode *node, vec<Lit> &join);
+  TreeNode *mergeNodes(vec<TreeNode *> &saturated);
+  void nodeObjFunction(TreeNode *node, vec<Lit> &lits);
+  int nodeSoft(TreeNode *node);
 
   vec< vec<int> > soft_partitions;
-  vec< vec<int> > soft_partitions_tmp;
 };
 } // namespace upmax
 
@@ -36,17 +36,14 @@ StatusCode UpOLL::unweighted() {
   initRelaxation();
   solver = rebuildSolver();
 
-  vec<Lit> assumptions;
+  AssumptionSet assumptions;
   vec<Lit> joinObjFunction;
   vec<Lit> currentObjFunction;
   vec<Lit> encodingAssumptions;
   encoder.setIncremental(_INCREMENTAL_ITERATIVE_);
 
   activeSoft.growTo(maxsat_formula->nSoft(), false);
-  for (int i = 0; i < maxsat_formula->nSoft(); i++)
-    coreMapping[maxsat_formula->getSoftClause(i).assumption_var] = i;
 
-  std::set<Lit> cardinality_assumptions;
   vec<Encoder *> soft_cardinality;
 
   int current_partition = 0;
@@ -59,29 +56,45 @@ StatusCode UpOLL::unweighted() {
   //   if(soft_partitions[i].size() > 0) _partitions++;
   // }
 
-  printf("c #Soft Partitions = %d\n",_partitions);
+  if (print)
+    printf("c #Soft Partitions = %d\n",_partitions);
+
+  partitionCores.clear();
+  if (_threads > 0) {
+    vec<Solver *> solvers;
+    for (int i = 0; i < std::min(_threads, _partitions); i++)
+      solvers.push(rebuildSolver());
+    StatusCode status =
+        extractPartitionCores(solvers, soft_partitions, _limit);
+    if (status != _UNKNOWN_)
+      return status;
+  }
    
   // while(soft_partitions[current_partition].size() == 0)
   //   current_partition++;
 
-  printf("c Partition #%d= %d\n",current_partition+1,soft_partitions[current_partition].size());
+  if (print)
+    printf("c Partition #%d= %d\n",current_partition+1,soft_partitions[current_partition].size());
+
+  int active_soft =
+      relaxPartitionCores(current_partition, soft_cardinality, assumptions);
 
    for (int i = 0; i < soft_partitions[current_partition].size(); i++){
     activeSoftPartition[soft_partitions[current_partition][i]] = true;
-    assumptions.push(~maxsat_formula->getSoftClause(soft_partitions[current_partition][i]).assumption_var);
+    if (!activeSoft[soft_partitions[current_partition][i]])
+      assumptions.add(~maxsat_formula->getSoftClause(soft_partitions[current_partition][i]).assumption_var);
    }
 
   // TODO: check if the hard clauses are satisfiable
 
-  int active_soft = 0;
-
   for (;;) {
 
     if (_limit != -1 && current_partition+1 != _partitions)
-      solver->setConfBudget(_limit);
+      conflict_budget.start(solver, current_partition);
     else
       solver->budgetOff();
-    res = searchSATSolver(solver, assumptions);
+    res = searchSATSolver(solver, assumptions.lits());
+    conflict_budget.finish(solver, res);
     if (res != l_False) {
       
       //while(soft_partitions[++current_partition].size() == 0)
@@ -92,19 +105,21 @@ StatusCode UpOLL::unweighted() {
 
       if (res == l_True){
         nbSatisfiable++;
-        printf("computing the cost\n");
+        if (print)
+          printf("computing the cost\n");
         uint64_t newCost = computeCostModel(solver->model);
         if (newCost <= ubCost){
           saveModel(solver->model);
           printBound(newCost);
           ubCost = newCost;
         }
+        improveModel(solver);
 
         if (ubCost == 0){
           printAnswer(_OPTIMUM_);
           return _OPTIMUM_;
         }
-      } else {
+      } else if (print) {
         printf("formula is unsat\n");
       }
 
@@ -113,11 +128,16 @@ StatusCode UpOLL::unweighted() {
         return _OPTIMUM_; 
       } else {
 
-        printf("c Partition #%d= %d\n",current_partition+1,soft_partitions[current_partition].size());
+        if (print)
+          printf("c Partition #%d= %d\n",current_partition+1,soft_partitions[current_partition].size());
+
+        active_soft += relaxPartitionCores(current_partition,
+                                           soft_cardinality, assumptions);
 
         for (int i = 0; i < soft_partitions[current_partition].size(); i++){
           activeSoftPartition[soft_partitions[current_partition][i]] = true;
-          assumptions.push(~maxsat_formula->getSoftClause(soft_partitions[current_partition][i]).assumption_var);
+          if (!activeSoft[soft_partitions[current_partition][i]])
+            assumptions.add(~maxsat_formula->getSoftClause(soft_partitions[current_partition][i]).assumption_var);
         }
 
       }      
@@ -125,6 +145,7 @@ StatusCode UpOLL::unweighted() {
     }
 
     if (res == l_False) {
+      minimizeCore(solver, solver->conflict);
       lbCost++;
       nbCores++;
       if (verbosity > 0)
@@ -145,49 +166,42 @@ StatusCode UpOLL::unweighted() {
 
       for (int i = 0; i < solver->conflict.size(); i++) {
         Lit p = solver->conflict[i];
-        if (coreMapping.find(p) != coreMapping.end()) {
-          assert(!activeSoft[coreMapping[p]]);
+        int index_soft = softIndex(p);
+        if (index_soft != -1) {
+          assert(!activeSoft[index_soft]);
           active_soft++;
-          activeSoft[coreMapping[solver->conflict[i]]] = true;
+          activeSoft[index_soft] = true;
+          assumptions.remove(~p);
           assert(p ==
-                 maxsat_formula->getSoftClause(coreMapping[solver->conflict[i]])
-                     .relaxation_vars[0]);
+                 maxsat_formula->getSoftClause(index_soft).relaxation_vars[0]);
           soft_relax.push(p);
         }
 
-        if (boundMapping.find(p) != boundMapping.end()) {
-          std::set<Lit>::iterator it;
-          it = cardinality_assumptions.find(p);
-          assert(it != cardinality_assumptions.end());
-          cardinality_assumptions.erase(it);
+        if (bounds.has(p)) {
+          bounds.deactivate(p);
+          assumptions.remove(~p);
           cardinality_relax.push(p);
 
           // this is a soft cardinality -- bound must be increased
-          std::pair<std::pair<int, int>, int> soft_id =
-              boundMapping[solver->conflict[i]];
+          int id = bounds.id(p);
+          int bound = bounds.bound(p);
           // increase the bound
-          assert(soft_id.first.first < soft_cardinality.size());
-          assert(soft_cardinality[soft_id.first.first]->hasCardEncoding());
+          assert(id < soft_cardinality.size());
+          assert(soft_cardinality[id]->hasCardEncoding());
 
           joinObjFunction.clear();
           encodingAssumptions.clear();
-          soft_cardinality[soft_id.first.first]->incUpdateCardinality(
-              solver, joinObjFunction,
-              soft_cardinality[soft_id.first.first]->lits(),
-              soft_id.first.second + 1, encodingAssumptions);
+          soft_cardinality[id]->incUpdateCardinality(
+              solver, joinObjFunction, soft_cardinality[id]->lits(), bound + 1,
+              encodingAssumptions);
 
           // if the bound is the same as the number of lits then no restriction
           // is applied
-          if (soft_id.first.second + 1 <
-              soft_cardinality[soft_id.first.first]->outputs().size()) {
-            assert(soft_cardinality[soft_id.first.first]->outputs().size() >
-                   soft_id.first.second + 1);
-            Lit out = soft_cardinality[soft_id.first.first]
-                          ->outputs()[soft_id.first.second + 1];
-            boundMapping[out] = std::make_pair(
-                std::make_pair(soft_id.first.first, soft_id.first.second + 1),
-                1);
-            cardinality_assumptions.insert(out);
+          if (bound + 1 < soft_cardinality[id]->outputs().size()) {
+            Lit out = soft_cardinality[id]->outputs()[bound + 1];
+            bounds.set(out, id, bound + 1, 1);
+            bounds.activate(out);
+            assumptions.add(~out);
           }
         }
       }
@@ -230,21 +244,9 @@ StatusCode UpOLL::unweighted() {
         assert(e->outputs().size() > 1);
 
         Lit out = e->outputs()[1];
-        boundMapping[out] =
-            std::make_pair(std::make_pair(soft_cardinality.size() - 1, 1), 1);
-        cardinality_assumptions.insert(out);
-      }
-
-      // reset the assumptions
-      assumptions.clear();
-      for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-        if (!activeSoft[i] && activeSoftPartition[i])
-          assumptions.push(~maxsat_formula->getSoftClause(i).assumption_var);
-      }
-
-      for (std::set<Lit>::iterator it = cardinality_assumptions.begin();
-           it != cardinality_assumptions.end(); ++it) {
-        assumptions.push(~(*it));
+        bounds.set(out, soft_cardinality.size() - 1, 1, 1);
+        bounds.activate(out);
+        assumptions.add(~out);
       }
 
       if (verbosity > 0) {
@@ -255,61 +257,139 @@ StatusCode UpOLL::unweighted() {
   }
 }
 
+/*_________________________________________________________________________________________________
+  |
+  |  relaxPartitionCores : (k : int) (soft_cardinality : vec<Encoder *>&)
+  |                        (assumptions : AssumptionSet&)  ->  [int]
+  |
+  |  Description:
+  |
+  |    Relaxes the disjoint cores of partition 'k' found before the search
+  |    (see 'extractPartitionCores') as if each one had been returned by the
+  |    SAT solver: the soft clauses of a core are no longer assumed and the
+  |    output of a totalizer over them (bounded by 1) is assumed instead.
+  |
+  |  Post-conditions:
+  |    * 'lbCost' is increased by the number of cores.
+  |    * Returns the number of relaxed soft clauses.
+  |
+  |________________________________________________________________________________________________@*/
+int UpOLL::relaxPartitionCores(int k, vec<Encoder *> &soft_cardinality,
+                               AssumptionSet &assumptions) {
+  if (k >= partitionCores.size())
+    return 0;
+
+  int relaxed = 0;
+  vec<Lit> soft_relax;
+  for (int i = 0; i < partitionCores[k].size(); i++) {
+    vec<int> &core = partitionCores[k][i];
+    lbCost++;
+    nbCores++;
+    sumSizeCores += core.size();
+
+    soft_relax.clear();
+    for (int j = 0; j < core.size(); j++) {
+      assert(!activeSoft[core[j]]);
+      activeSoft[core[j]] = true;
+      soft_relax.push(maxsat_formula->getSoftClause(core[j]).relaxation_vars[0]);
+    }
+    relaxed += soft_relax.size();
+
+    if (soft_relax.size() == 1) {
+      // Unit core
+      solver->addClause(soft_relax[0]);
+      continue;
+    }
+
+    Encoder *e = new Encoder();
+    e->setIncremental(_INCREMENTAL_ITERATIVE_);
+    e->buildCardinality(solver, soft_relax, 1);
+    soft_cardinality.push(e);
+
+    Lit out = e->outputs()[1];
+    bounds.set(out, soft_cardinality.size() - 1, 1, 1);
+    bounds.activate(out);
+    assumptions.add(~out);
+  }
+
+  if (verbosity > 0 && partitionCores[k].size() > 0)
+    printf("c LB : %-12" PRIu64 "\n", lbCost);
+
+  return relaxed;
+}
+
 StatusCode UpOLL::weighted() {
   
   lbool res = l_True;
   initRelaxation();
   solver = rebuildSolver();
 
-  vec<Lit> assumptions;
-  vec<Lit> joinObjFunction;
+  AssumptionSet assumptions;
   vec<Lit> currentObjFunction;
-  vec<Lit> encodingAssumptions;
   encoder.setIncremental(_INCREMENTAL_ITERATIVE_);
 
   activeSoft.growTo(maxsat_formula->nSoft(), false);
-  for (int i = 0; i < maxsat_formula->nSoft(); i++)
-    coreMapping[maxsat_formula->getSoftClause(i).assumption_var] = i;
 
-  std::set<Lit> cardinality_assumptions;
   vec<Encoder *> soft_cardinality;
 
-  //min_weight = maxsat_formula->getMaximumWeight();
-  min_weight = 1;
-  // printf("current weight %d\n",maxsat_formula->getMaximumWeight());
-
- int current_partition = 0;
- activeSoftPartition.clear();
+  int current_partition = 0;
+  activeSoftPartition.clear();
   activeSoftPartition.growTo(maxsat_formula->nSoft(), false);
   
+  // Lexicographic formulas are solved one weight level at a time, and the
+  // partitions are restricted to the soft clauses of the current level.
+  bool bmo = bmo_search && isBMO();
+  int level = 0;
+  PartitionSchedule schedule(maxsat_formula, partition_order);
+  vec<vec<int>> partitions;
+  if (bmo) {
+    _strat = _STRAT_NONE_;
+    soft_partitions.moveTo(partitions);
+    schedule.buildLevel(partitions, orderWeights[level], soft_partitions);
+    if (print)
+      printf("c Level #%d weight = %" PRIu64 "\n", level + 1,
+             orderWeights[level]);
+  }
+
   //int id_partition = 1;
   _partitions = soft_partitions.size();
   // for (int i = 0; i < soft_partitions.size(); i++){
   //   if(soft_partitions[i].size() > 0) _partitions++;
   // }
 
-  printf("c #Soft Partitions = %d\n",_partitions);
+  if (print)
+    printf("c #Soft Partitions = %d\n",_partitions);
    
   // while(soft_partitions[current_partition].size() == 0)
   //   current_partition++;
 
-  printf("c Partition #%d= %d\n",current_partition+1,soft_partitions[current_partition].size());
+  if (print)
+    printf("c Partition #%d= %d\n",current_partition+1,soft_partitions[current_partition].size());
 
-   for (int i = 0; i < soft_partitions[current_partition].size(); i++){
+  for (int i = 0; i < soft_partitions[current_partition].size(); i++)
     activeSoftPartition[soft_partitions[current_partition][i]] = true;
-    assumptions.push(~maxsat_formula->getSoftClause(soft_partitions[current_partition][i]).assumption_var);
-   }
+
+  // Without stratification all soft clauses and soft cardinality constraints
+  // are assumed since 'min_weight' is 1.
+  min_weight = 1;
+  if (_strat != _STRAT_NONE_)
+    min_weight = findNextWeightDiversity(UINT64_MAX);
+  if (bmo)
+    min_weight = orderWeights[level];
+  resetAssumptions(assumptions, current_partition);
 
   // TODO: check if the hard clauses are satisfiable
 
+  int active_soft = 0;
 
   for (;;) {
 
     if (_limit != -1 && current_partition+1 != _partitions)
-      solver->setConfBudget(_limit);
+      conflict_budget.start(solver, current_partition);
     else
       solver->budgetOff();
-    res = searchSATSolver(solver, assumptions);
+    res = searchSATSolver(solver, assumptions.lits());
+    conflict_budget.finish(solver, res);
     if (res != l_False) {
       
       if (res == l_True){
@@ -320,6 +400,68 @@ StatusCode UpOLL::weighted() {
           printBound(newCost);
           ubCost = newCost;
         }
+        improveModel(solver);
+      }
+
+      if (pendingCores.size() + pendingBounds.size() + pendingSplits.size() >
+          0) {
+        relaxPendingCores(soft_cardinality, assumptions);
+        continue;
+      }
+
+      hardenObjective(assumptions);
+
+      // The optimum of the level is found once all of its partitions are
+      // active. Since all soft clauses of a level have the same weight, so
+      // do the soft cardinality constraints, and hardening the assumptions
+      // fixes the optimum of the level.
+      if (bmo && current_partition + 1 == _partitions &&
+          level + 1 < (int)orderWeights.size()) {
+        hardenLevel(solver, assumptions.lits());
+        for (int i = 0; i < assumptions.lits().size(); i++)
+          if (bounds.isActive(~assumptions.lits()[i]))
+            bounds.deactivate(~assumptions.lits()[i]);
+
+        level++;
+        min_weight = orderWeights[level];
+        schedule.buildLevel(partitions, min_weight, soft_partitions);
+        _partitions = soft_partitions.size();
+        if (print) {
+          printf("c Level #%d weight = %" PRIu64 "\n", level + 1, min_weight);
+          printf("c #Soft Partitions = %d\n", _partitions);
+        }
+
+        for (int i = 0; i < activeSoftPartition.size(); i++)
+          activeSoftPartition[i] = false;
+        current_partition = 0;
+        if (print)
+          printf("c Partition #%d= %d\n", current_partition + 1,
+                 soft_partitions[current_partition].size());
+        for (int i = 0; i < soft_partitions[current_partition].size(); i++)
+          activeSoftPartition[soft_partitions[current_partition][i]] = true;
+        resetAssumptions(assumptions, current_partition);
+        continue;
+      }
+
+      // Descend to the next stratum, either before each partition is
+      // activated or once all partitions are active.
+      if (_strat != _STRAT_NONE_ &&
+          (_strat == _STRAT_PARTITION_ ||
+           current_partition + 1 == _partitions) &&
+          nonAssumed() > 0) {
+        min_weight = findNextWeightDiversity(min_weight);
+        if (verbosity > 0)
+          printf("c Stratum weight : %-12" PRIu64 "\n", min_weight);
+
+        // Partitions are activated again for each stratum.
+        if (_strat == _STRAT_WEIGHT_) {
+          for (int k = 1; k <= current_partition; k++)
+            for (int i = 0; i < soft_partitions[k].size(); i++)
+              activeSoftPartition[soft_partitions[k][i]] = false;
+          current_partition = 0;
+        }
+        resetAssumptions(assumptions, current_partition);
+        continue;
       }
 
       if(current_partition+1 == _partitions){
@@ -328,34 +470,41 @@ StatusCode UpOLL::weighted() {
       } else {
 
         current_partition++;
-        printf("c Partition #%d= %d\n",current_partition+1,soft_partitions[current_partition].size());
+        if (print)
+          printf("c Partition #%d= %d\n",current_partition+1,soft_partitions[current_partition].size());
 
-        for (int i = 0; i < soft_partitions[current_partition].size(); i++){
+        for (int i = 0; i < soft_partitions[current_partition].size(); i++)
           activeSoftPartition[soft_partitions[current_partition][i]] = true;
-          assumptions.push(~maxsat_formula->getSoftClause(soft_partitions[current_partition][i]).assumption_var);
+
+        if (_strat == _STRAT_PARTITION_) {
+          // The strata are descended again from the heaviest soft clauses.
+          min_weight = findNextWeightDiversity(UINT64_MAX);
+          resetAssumptions(assumptions, current_partition);
+        } else {
+          for (int i = 0; i < soft_partitions[current_partition].size(); i++) {
+            int index_soft = soft_partitions[current_partition][i];
+            if (!activeSoft[index_soft] && !isHardened(index_soft) &&
+                maxsat_formula->getSoftClause(index_soft).weight >= min_weight)
+              assumptions.add(~getAssumptionLit(index_soft));
+          }
         }
       }
     } else {
+      minimizeCore(solver, solver->conflict);
 
       // reduce the weighted to the unweighted case
       uint64_t min_core = UINT64_MAX;
       for (int i = 0; i < solver->conflict.size(); i++) {
         Lit p = solver->conflict[i];
-        if (coreMapping.find(p) != coreMapping.end()) {
-          assert(!activeSoft[coreMapping[p]]);
-          if (maxsat_formula->getSoftClause(coreMapping[solver->conflict[i]])
-                  .weight < min_core)
-            min_core =
-                maxsat_formula->getSoftClause(coreMapping[solver->conflict[i]])
-                    .weight;
+        int index_soft = softIndex(p);
+        if (index_soft != -1) {
+          assert(!activeSoft[index_soft]);
+          if (maxsat_formula->getSoftClause(index_soft).weight < min_core)
+            min_core = maxsat_formula->getSoftClause(index_soft).weight;
         }
 
-        if (boundMapping.find(p) != boundMapping.end()) {
-          std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-              boundMapping[solver->conflict[i]];
-          if (soft_id.second < min_core)
-            min_core = soft_id.second;
-        }
+        if (bounds.has(p) && bounds.weight(p) < min_core)
+          min_core = bounds.weight(p);
       }
 
       // printf("MIN CORE %d\n",min_core);
@@ -385,12 +534,13 @@ StatusCode UpOLL::weighted() {
 
       for (int i = 0; i < solver->conflict.size(); i++) {
         Lit p = solver->conflict[i];
-        if (coreMapping.find(p) != coreMapping.end()) {
-          if (maxsat_formula->getSoftClause(coreMapping[p]).weight > min_core) {
+        int index_soft = softIndex(p);
+        if (index_soft != -1) {
+          if (maxsat_formula->getSoftClause(index_soft).weight > min_core) {
             // printf("SPLIT THE CLAUSE\n");
-            assert(!activeSoft[coreMapping[p]]);
+            assert(!activeSoft[index_soft]);
             // SPLIT THE CLAUSE
-            int indexSoft = coreMapping[p];
+            int indexSoft = index_soft;
             assert(maxsat_formula->getSoftClause(indexSoft).weight - min_core >
                    0);
 
@@ -414,6 +564,7 @@ StatusCode UpOLL::weighted() {
             // vars);
             maxsat_formula->addSoftClause(min_core, clause, vars);
             activeSoft.push(true);
+            active_soft++;
 
             // Add information to the SAT solver
             newSATVariable(solver);
@@ -433,184 +584,45 @@ StatusCode UpOLL::weighted() {
                        .assumption_var ==
                    maxsat_formula->getSoftClause(maxsat_formula->nSoft() - 1)
                        .relaxation_vars[0]);
-            coreMapping[l] =
-                maxsat_formula->nSoft() -
-                1; // Map the new soft clause to its assumption literal.
+            // Map the new soft clause to its assumption literal.
+            setCoreMapping(l, maxsat_formula->nSoft() - 1);
 
             soft_relax.push(l);
-            assert(maxsat_formula->getSoftClause(coreMapping[l]).weight ==
+            assert(maxsat_formula->getSoftClause(softIndex(l)).weight ==
                    min_core);
             assert(activeSoft.size() == maxsat_formula->nSoft());
 
           } else {
             // printf("NOT SPLITTING\n");
-            assert(
-                maxsat_formula->getSoftClause(coreMapping[solver->conflict[i]])
-                    .weight == min_core);
+            assert(maxsat_formula->getSoftClause(index_soft).weight ==
+                   min_core);
             soft_relax.push(p);
             // printf("ASSERT %d\n",var(p)+1);
-            assert(!activeSoft[coreMapping[p]]);
-            activeSoft[coreMapping[p]] = true;
+            assert(!activeSoft[index_soft]);
+            activeSoft[index_soft] = true;
+            assumptions.remove(~p);
+            active_soft++;
           }
         }
 
-        if (boundMapping.find(p) != boundMapping.end()) {
-          // printf("CARD IN CORE\n");
-
-          std::set<Lit>::iterator it;
-          it = cardinality_assumptions.find(p);
-          assert(it != cardinality_assumptions.end());
-
-          // this is a soft cardinality -- bound must be increased
-          std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-              boundMapping[solver->conflict[i]];
-          // increase the bound
-          assert(soft_id.first.first < soft_cardinality.size());
-          assert(soft_cardinality[soft_id.first.first]->hasCardEncoding());
-
-          if (soft_id.second == min_core) {
-
-            cardinality_assumptions.erase(it);
-            cardinality_relax.push(p);
-
-            joinObjFunction.clear();
-            encodingAssumptions.clear();
-            soft_cardinality[soft_id.first.first]->incUpdateCardinality(
-                solver, joinObjFunction,
-                soft_cardinality[soft_id.first.first]->lits(),
-                soft_id.first.second + 1, encodingAssumptions);
-
-            // if the bound is the same as the number of lits then no
-            // restriction is applied
-            if (soft_id.first.second + 1 <
-                (unsigned)soft_cardinality[soft_id.first.first]
-                    ->outputs()
-                    .size()) {
-              assert((unsigned)soft_cardinality[soft_id.first.first]
-                         ->outputs()
-                         .size() > soft_id.first.second + 1);
-              Lit out = soft_cardinality[soft_id.first.first]
-                            ->outputs()[soft_id.first.second + 1];
-              boundMapping[out] = std::make_pair(
-                  std::make_pair(soft_id.first.first, soft_id.first.second + 1),
-                  min_core);
-              cardinality_assumptions.insert(out);
-            }
+        if (bounds.has(p)) {
+          assert(bounds.isActive(p));
+          uint64_t weight = bounds.weight(p);
 
+          if (weight == min_core) {
+            // The bound is increased once the solver returns SAT.
+            bounds.deactivate(p);
+            assumptions.remove(~p);
+            pendingBounds.push(p);
           } else {
-
-#if 1
-            // duplicate cardinality constraint???
-            Encoder *e = new Encoder();
-            e->setIncremental(_INCREMENTAL_ITERATIVE_);
-            e->buildCardinality(solver,
-                                soft_cardinality[soft_id.first.first]->lits(),
-                                soft_id.first.second);
-
-            assert((unsigned)e->outputs().size() > soft_id.first.second);
-            Lit out = e->outputs()[soft_id.first.second];
-            soft_cardinality.push(e);
-
-            boundMapping[out] =
-                std::make_pair(std::make_pair(soft_cardinality.size() - 1,
-                                              soft_id.first.second),
-                               min_core);
-            cardinality_relax.push(out);
-
-            // Update value of the previous cardinality constraint
-            assert(soft_id.second - min_core > 0);
-            boundMapping[p] = std::make_pair(
-                std::make_pair(soft_id.first.first, soft_id.first.second),
-                soft_id.second - min_core);
-
-            // Update bound as usual...
-
-            std::pair<std::pair<int, int>, int> soft_core_id =
-                boundMapping[out];
-
-            joinObjFunction.clear();
-            encodingAssumptions.clear();
-            soft_cardinality[soft_core_id.first.first]->incUpdateCardinality(
-                solver, joinObjFunction,
-                soft_cardinality[soft_core_id.first.first]->lits(),
-                soft_core_id.first.second + 1, encodingAssumptions);
-
-            // if the bound is the same as the number of lits then no
-            // restriction is applied
-            if (soft_core_id.first.second + 1 <
-                soft_cardinality[soft_core_id.first.first]->outputs().size()) {
-              assert(
-                  soft_cardinality[soft_core_id.first.first]->outputs().size() >
-                  soft_core_id.first.second + 1);
-              Lit out = soft_cardinality[soft_core_id.first.first]
-                            ->outputs()[soft_core_id.first.second + 1];
-              boundMapping[out] =
-                  std::make_pair(std::make_pair(soft_core_id.first.first,
-                                                soft_core_id.first.second + 1),
-                                 min_core);
-              cardinality_assumptions.insert(out);
-            }
-#else
-
-            // FIXME: improve the OLL algorithm by reusing the cardinality
-            // constraint This current alternative does not work!
-            while (nVars() < solver->nVars())
-              newLiteral();
-
-            Lit l = newLiteral();
-
-            // Add information to the SAT solver
-            newSATVariable(solver);
-            vec<Lit> clause;
-            clause.push(l);
-            clause.push(~p);
-            solver->addClause(clause);
-
-            clause.clear();
-            clause.push(~l);
-            clause.push(p);
-            solver->addClause(clause);
-
-            boundMapping[l] = std::make_pair(
-                std::make_pair(soft_id.first.first, soft_id.first.second),
-                min_core);
-            cardinality_relax.push(l);
-
-            // Update bound as usual...
-
-            std::pair<std::pair<int, int>, int> soft_core_id = boundMapping[p];
-
-            joinObjFunction.clear();
-            encodingAssumptions.clear();
-            soft_cardinality[soft_core_id.first.first]->incUpdateCardinality(
-                solver, joinObjFunction,
-                soft_cardinality[soft_core_id.first.first]->lits(),
-                soft_core_id.first.second + 1, encodingAssumptions);
-
-            // if the bound is the same as the number of lits then no
-            // restriction is applied
-            if (soft_core_id.first.second + 1 <
-                soft_cardinality[soft_core_id.first.first]->outputs().size()) {
-              assert(
-                  soft_cardinality[soft_core_id.first.first]->outputs().size() >
-                  soft_core_id.first.second + 1);
-              Lit out = soft_cardinality[soft_core_id.first.first]
-                            ->outputs()[soft_core_id.first.second + 1];
-              boundMapping[out] =
-                  std::make_pair(std::make_pair(soft_core_id.first.first,
-                                                soft_core_id.first.second + 1),
-                                 min_core);
-              cardinality_assumptions.insert(out);
-            }
-
-            // Update value of the previous cardinality constraint
-            assert(soft_id.second - min_core > 0);
-            boundMapping[p] = std::make_pair(
-                std::make_pair(soft_id.first.first, soft_id.first.second),
-                soft_id.second - min_core);
-
-#endif
+            // The remaining weight of 'p' is still assumed. The next bound
+            // with the weight of the core is added once the solver returns
+            // SAT.
+            bounds.setWeight(p, weight - min_core);
+            pendingSplits.push(p);
+            pendingSplitWeights.push(min_core);
           }
+          cardinality_relax.push(p);
         }
       }
 
@@ -618,76 +630,280 @@ StatusCode UpOLL::weighted() {
 
       if (soft_relax.size() == 1 && cardinality_relax.size() == 0) {
         // Unit core
-        // printf("UNIT CORE\n");
         solver->addClause(soft_relax[0]);
       }
 
-      // assert (soft_relax.size() > 0 || cardinality_relax.size() != 1);
-
       if (soft_relax.size() + cardinality_relax.size() > 1) {
-
-        vec<Lit> relax_harden;
-        soft_relax.copyTo(relax_harden);
+        // The cardinality constraint of the core is only built once the
+        // solver returns SAT (see 'relaxPendingCores').
+        pendingCores.push();
+        soft_relax.copyTo(pendingCores.last());
         for (int i = 0; i < cardinality_relax.size(); i++)
-          relax_harden.push(cardinality_relax[i]);
+          pendingCores.last().push(cardinality_relax[i]);
+        pendingCoreWeights.push(min_core);
+      }
 
-        /*
-        for (int i = 0; i < nSoft(); i++){
-          printf("soft %d, w: %d, r:
-        %d\n",i,softClauses[i].weight,var(softClauses[i].relaxationVars[0])+1);
-          for (int j = 0; j < softClauses[i].clause.size(); j++){
-            printf("%d ",var(softClauses[i].clause[j])+1);
-          }
-          printf("\n");
-        }
+      if (verbosity > 0) {
+        printf("c Relaxed soft clauses %d / %d\n", active_soft,
+               maxsat_formula->nSoft());
+      }
+    }
+  }
+}
 
-        for (int i = 0; i < relax_harden.size(); i++)
-          printf("+1 x%d ",var(relax_harden[i])+1);
-        printf(" <= 1\n");
-        */
-        Encoder *e = new Encoder();
-        e->setIncremental(_INCREMENTAL_ITERATIVE_);
-        e->buildCardinality(solver, relax_harden, 1);
-        soft_cardinality.push(e);
-        assert(e->outputs().size() > 1);
+/*_________________________________________________________________________________________________
+  |
+  |  hardenObjective : (assumptions : AssumptionSet&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Hardens the soft clauses that are not relaxed and the outputs of the
+  |    soft cardinality constraints whose remaining weight exceeds the gap
+  |    between 'ubCost' and 'lbCost' (see 'hardenSoftClauses'). Every
+  |    assignment costs at least 'lbCost' plus the weights of the objective
+  |    literals it falsifies, so the best model satisfies all of them.
+  |
+  |  Pre-conditions:
+  |    * There are no pending cores.
+  |
+  |  Post-conditions:
+  |    * The hardened literals are no longer assumed.
+  |
+  |________________________________________________________________________________________________@*/
+void UpOLL::hardenObjective(AssumptionSet &assumptions) {
+  vec<Lit> units;
+  hardenSoftClauses(solver, lbCost, units, &activeSoft);
+  for (int i = 0; i < units.size(); i++)
+    assumptions.remove(units[i]);
+
+  units.clear();
+  for (Lit q = bounds.first(); q != lit_Undef; q = bounds.next(q))
+    if (canHarden(bounds.weight(q), lbCost))
+      units.push(~q);
+
+  for (int i = 0; i < units.size(); i++) {
+    solver->addClause(units[i]);
+    bounds.deactivate(~units[i]);
+    assumptions.remove(units[i]);
+    nbHardened++;
+  }
+}
 
-        // printf("outputs %d\n",e->outputs().size());
-        Lit out = e->outputs()[1];
-        boundMapping[out] = std::make_pair(
-            std::make_pair(soft_cardinality.size() - 1, 1), min_core);
-        cardinality_assumptions.insert(out);
-      }
+/*_________________________________________________________________________________________________
+  |
+  |  resetAssumptions : (assumptions : AssumptionSet&) (current_partition : int)
+  |                     ->  [void]
+  |
+  |  Description:
+  |
+  |    Assumes the soft clauses of partitions up to 'current_partition' that
+  |    are not relaxed and the soft cardinality constraints, as long as their
+  |    weight is at least 'min_weight'.
+  |
+  |________________________________________________________________________________________________@*/
+void UpOLL::resetAssumptions(AssumptionSet &assumptions, int current_partition) {
+  assumptions.clear();
+  for (int k = 0; k <= current_partition; k++) {
+    for (int i = 0; i < soft_partitions[k].size(); i++) {
+      int index_soft = soft_partitions[k][i];
+      if (activeSoftPartition[index_soft] && !activeSoft[index_soft] &&
+          !isHardened(index_soft) &&
+          maxsat_formula->getSoftClause(index_soft).weight >= min_weight)
+        assumptions.add(~getAssumptionLit(index_soft));
+    }
+  }
 
-      // reset the assumptions
-      assumptions.clear();
-      int active_soft = 0;
-      for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-        if (!activeSoft[i] && activeSoftPartition[i]) {
-          assumptions.push(~maxsat_formula->getSoftClause(i).assumption_var);
-          // printf("s assumption %d\n",var(softClauses[i].assumptionVar)+1);
-        } else
-          active_soft++;
+  for (Lit q = bounds.first(); q != lit_Undef; q = bounds.next(q))
+    if (bounds.weight(q) >= min_weight)
+      assumptions.add(~q);
+}
+
+// Soft clauses of active partitions and soft cardinality constraints that
+// are not assumed due to their weight.
+int UpOLL::nonAssumed() {
+  int not_considered = 0;
+  for (int i = 0; i < activeSoftPartition.size(); i++)
+    if (activeSoftPartition[i] && !activeSoft[i] && !isHardened(i) &&
+        maxsat_formula->getSoftClause(i).weight < min_weight)
+      not_considered++;
+
+  for (Lit q = bounds.first(); q != lit_Undef; q = bounds.next(q))
+    if (bounds.weight(q) < min_weight)
+      not_considered++;
+
+  return not_considered;
+}
+
+// Largest weight below 'weight' of soft clauses of active partitions and
+// soft cardinality constraints (1 if there is none).
+uint64_t UpOLL::findNextWeight(uint64_t weight) {
+  uint64_t nextWeight = 1;
+  for (int i = 0; i < activeSoftPartition.size(); i++) {
+    if (!activeSoftPartition[i] || activeSoft[i])
+      continue;
+    uint64_t w = maxsat_formula->getSoftClause(i).weight;
+    if (w > nextWeight && w < weight)
+      nextWeight = w;
+  }
+
+  for (Lit q = bounds.first(); q != lit_Undef; q = bounds.next(q)) {
+    uint64_t w = bounds.weight(q);
+    if (w > nextWeight && w < weight)
+      nextWeight = w;
+  }
+
+  return nextWeight;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  findNextWeightDiversity : (weight : uint64_t)  ->  [uint64_t]
+  |
+  |  Description:
+  |
+  |    Diversity-based stratification of OLL, restricted to the soft clauses
+  |    of active partitions that are not relaxed and to the soft cardinality
+  |    constraints. The weight is lowered until the ratio between the number
+  |    of literals and the number of different weights above it is larger
+  |    than 'alpha', or all literals are above it.
+  |
+  |________________________________________________________________________________________________@*/
+uint64_t UpOLL::findNextWeightDiversity(uint64_t weight) {
+  uint64_t nextWeight = weight;
+  std::set<uint64_t> nbWeights;
+  float alpha = 1.25;
+
+  int nbTotal = bounds.nActive();
+  for (int i = 0; i < activeSoftPartition.size(); i++)
+    if (activeSoftPartition[i] && !activeSoft[i])
+      nbTotal++;
+
+  for (;;) {
+    nextWeight = findNextWeight(nextWeight);
+
+    int nbClauses = 0;
+    nbWeights.clear();
+    for (int i = 0; i < activeSoftPartition.size(); i++) {
+      if (!activeSoftPartition[i] || activeSoft[i])
+        continue;
+      uint64_t w = maxsat_formula->getSoftClause(i).weight;
+      if (w >= nextWeight) {
+        nbClauses++;
+        nbWeights.insert(w);
       }
+    }
 
-      // printf("assumptions %d\n",assumptions.size());
-      for (std::set<Lit>::iterator it = cardinality_assumptions.begin();
-           it != cardinality_assumptions.end(); ++it) {
-        assert(boundMapping.find(*it) != boundMapping.end());
-        std::pair<std::pair<int, uint64_t>, uint64_t> soft_id =
-            boundMapping[*it];
-        if (soft_id.second >= min_weight)
-          assumptions.push(~(*it));
-        // printf("c assumption %d\n",var(*it)+1);
+    for (Lit q = bounds.first(); q != lit_Undef; q = bounds.next(q)) {
+      uint64_t w = bounds.weight(q);
+      if (w >= nextWeight) {
+        nbClauses++;
+        nbWeights.insert(w);
       }
+    }
 
-      // printf("card assumptions %d\n",assumptions.size());
+    if (nbClauses == nbTotal ||
+        (float)nbClauses / nbWeights.size() > alpha)
+      break;
+  }
 
-      if (verbosity > 0) {
-        printf("c Relaxed soft clauses %d / %d\n", active_soft,
-               maxsat_formula->nSoft());
-      }
+  return nextWeight;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  relaxPendingCores : (soft_cardinality : vec<Encoder *>&)
+  |                      (assumptions : AssumptionSet&)  ->  [void]
+  |
+  |  Description:
+  |
+  |    Weight-aware core extraction for the weighted algorithm. When a core is
+  |    found, only the residual weights of its literals are lowered and the
+  |    literals whose weight is exhausted are no longer assumed. The
+  |    cardinality constraints of the cores are built here, once the solver
+  |    returns SAT, instead of after each core.
+  |
+  |  Post-conditions:
+  |    * The outputs with bound 1 of the new cardinality constraints and the
+  |      next bound of each pending cardinality constraint are assumed.
+  |    * The pending cores, bounds and splits are cleared.
+  |
+  |________________________________________________________________________________________________@*/
+void UpOLL::relaxPendingCores(vec<Encoder *> &soft_cardinality,
+                              AssumptionSet &assumptions) {
+  vec<Lit> joinObjFunction;
+  vec<Lit> encodingAssumptions;
+
+  // Increase the bound of cardinality constraints whose weight is exhausted.
+  for (int i = 0; i < pendingBounds.size(); i++) {
+    Lit p = pendingBounds[i];
+    int id = bounds.id(p);
+    uint64_t bound = bounds.bound(p);
+    assert(id < soft_cardinality.size());
+    assert(soft_cardinality[id]->hasCardEncoding());
+
+    joinObjFunction.clear();
+    encodingAssumptions.clear();
+    soft_cardinality[id]->incUpdateCardinality(
+        solver, joinObjFunction, soft_cardinality[id]->lits(), bound + 1,
+        encodingAssumptions);
+
+    // if the bound is the same as the number of lits then no
+    // restriction is applied
+    if (bound + 1 < (unsigned)soft_cardinality[id]->outputs().size()) {
+      Lit out = soft_cardinality[id]->outputs()[bound + 1];
+      bounds.set(out, id, bound + 1, bounds.weight(p));
+      bounds.activate(out);
+      assumptions.add(~out);
     }
   }
+
+  // Cardinality constraints that kept part of their weight are duplicated
+  // for the next bound with the weight of the core.
+  for (int i = 0; i < pendingSplits.size(); i++) {
+    Lit p = pendingSplits[i];
+    int id = bounds.id(p);
+    uint64_t bound = bounds.bound(p);
+
+    Encoder *e = new Encoder();
+    e->setIncremental(_INCREMENTAL_ITERATIVE_);
+    e->buildCardinality(solver, soft_cardinality[id]->lits(), bound);
+    soft_cardinality.push(e);
+    int core_id = soft_cardinality.size() - 1;
+
+    joinObjFunction.clear();
+    encodingAssumptions.clear();
+    e->incUpdateCardinality(solver, joinObjFunction, e->lits(), bound + 1,
+                            encodingAssumptions);
+
+    if (bound + 1 < (unsigned)e->outputs().size()) {
+      Lit out = e->outputs()[bound + 1];
+      bounds.set(out, core_id, bound + 1, pendingSplitWeights[i]);
+      bounds.activate(out);
+      assumptions.add(~out);
+    }
+  }
+
+  for (int i = 0; i < pendingCores.size(); i++) {
+    Encoder *e = new Encoder();
+    e->setIncremental(_INCREMENTAL_ITERATIVE_);
+    e->buildCardinality(solver, pendingCores[i], 1);
+    soft_cardinality.push(e);
+    assert(e->outputs().size() > 1);
+
+    Lit out = e->outputs()[1];
+    bounds.set(out, soft_cardinality.size() - 1, 1, pendingCoreWeights[i]);
+    bounds.activate(out);
+    assumptions.add(~out);
+  }
+
+  if (verbosity > 0)
+    printf("c Relaxed cores %d\n", pendingCores.size());
+
+  pendingBounds.clear();
+  pendingSplits.clear();
+  pendingSplitWeights.clear();
+  pendingCores.clear();
+  pendingCoreWeights.clear();
 }
 
 StatusCode UpOLL::search() {
@@ -703,10 +919,10 @@ StatusCode UpOLL::search() {
   }
 
   printConfiguration();
-  createPartitions();
+  PartitionSchedule schedule(maxsat_formula, partition_order);
+  schedule.build(soft_partitions);
   
   if (maxsat_formula->getProblemType() == _WEIGHTED_) {
-    // FIXME: consider lexicographical optimization for weighted problems
     return weighted();
   } else
     return unweighted();
@@ -812,42 +1028,6 @@ void UpOLL::initRelaxation() {
     Lit l = maxsat_formula->newLiteral();
     maxsat_formula->getSoftClause(i).relaxation_vars.push(l);
     maxsat_formula->getSoftClause(i).assumption_var = l;
+    setCoreMapping(l, i);
   }
 }
-
-
-void UpOLL::createPartitions() {
-  _partitions = 0;
-
-  for (int i = 0; i < maxsat_formula->nPartitions()+1; i++){
-    soft_partitions_tmp.push();
-    new (&soft_partitions_tmp[i]) vec<int>();
-  }
-
-  for (int i = 0; i < maxsat_formula->nSoft(); i++){
-    int v = maxsat_formula->getSoftClause(i).getPartition();
-    if (v == -1) v = maxsat_formula->nPartitions();
-    assert (v >= 0 && v < soft_partitions_tmp.size());
-    soft_partitions_tmp[v].push(i);
-  }  
-
-  std::vector< pair <int,int> > vect;
-  for (int i = 0; i < soft_partitions_tmp.size(); i++){
-    vect.push_back( std::make_pair(soft_partitions_tmp[i].size(), i) );
-  }
-
-  std::sort(vect.begin(), vect.end());
-  for (int i = 0; i < vect.size(); i++){
-    if (vect[i].first > 0){
-      soft_partitions.push();
-      new (&soft_partitions[soft_partitions.size()-1]) vec<int>();
-      for (int j = 0; j < soft_partitions_tmp[vect[i].second].size(); j++){
-        int v = soft_partitions_tmp[vect[i].second][j];
-        soft_partitions[soft_partitions.size()-1].push(v);
-      }
-      soft_partitions_tmp[vect[i].second].clear();
-    } else soft_partitions_tmp[vect[i].second].clear();
-  }
-  soft_partitions_tmp.clear();
-
-}
\ No newline at end of file
@@ -31,7 +31,10 @@
 
 #include "core/Solver.h"
 
+#include "../CardinalityBounds.h"
+#include "../AssumptionSet.h"
 #include "../Encoder.h"
+#include "../PartitionSchedule.h"
 #include "../MaxSAT_Partition.h"
 #include <map>
 #include <set>
@@ -43,14 +46,19 @@ class UpOLL : public MaxSAT_Partition {
 
 public:
   //PWCNFOLL(int verb = _VERBOSITY_MINIMAL_, int enc = _CARD_TOTALIZER_) {
-  UpOLL(int verb = _VERBOSITY_SOME_, int mode = _SIZE_, int limit = -1) {
+  UpOLL(int verb = _VERBOSITY_SOME_, int mode = _SIZE_, int limit = -1,
+        int strat = _STRAT_NONE_, int threads = 0) {
     solver = NULL;
     verbosity = verb;
     incremental_strategy = _INCREMENTAL_ITERATIVE_;
     encoding = _CARD_TOTALIZER_;
     encoder.setCardEncoding(_CARD_TOTALIZER_);
     min_weight = 1;
+    _mode = mode;
     _limit = limit;
+    conflict_budget.setLimit(limit);
+    _strat = strat;
+    _threads = threads;
   }
   ~UpOLL() {
     if (solver != NULL)
@@ -86,6 +94,22 @@ protected:
 
   StatusCode unweighted();
   StatusCode weighted();
+  // Relaxes the cores of partition 'k' found before the search (unweighted).
+  int relaxPartitionCores(int k, vec<Encoder *> &soft_cardinality,
+                          AssumptionSet &assumptions);
+  // Builds the cardinality constraints of the cores found since the last
+  // SAT call (weighted).
+  void relaxPendingCores(vec<Encoder *> &soft_cardinality,
+                         AssumptionSet &assumptions);
+
+  // Hardens the objective literals by the bounds (weighted).
+  void hardenObjective(AssumptionSet &assumptions);
+
+  // Stratification (weighted).
+  void resetAssumptions(AssumptionSet &assumptions, int current_partition);
+  int nonAssumed();
+  uint64_t findNextWeight(uint64_t weight);
+  uint64_t findNextWeightDiversity(uint64_t weight);
 
   Solver *solver;  // SAT Solver used as a black box.
   Encoder encoder; // Interface for the encoder of constraints to CNF.
@@ -100,30 +124,30 @@ protected:
   vec<uint64_t> coeffs; // Coefficients of the literals that are used in the
                         // constraint that excludes models.
 
-  std::map<Lit, int> coreMapping; // Mapping between the assumption literal and
-                                  // the respective soft clause.
-
-  std::map<Lit, int>
-      coreCardinality; // Mapping between the assumption literal and
-                       // the respective soft clause.
-
-  // lit -> <ID, bound, weight>
-  std::map<Lit, std::pair<std::pair<int, uint64_t>, uint64_t>> boundMapping;
+  // Outputs of the soft cardinality constraints with their bounds and weights.
+  CardinalityBounds bounds;
 
   // Soft clauses that are currently in the MaxSAT formula.
   vec<bool> activeSoft;
 
+  // Weight-aware core extraction (weighted).
+  vec<vec<Lit>> pendingCores;     // Relaxation literals of each core.
+  vec<uint64_t> pendingCoreWeights;
+  vec<Lit> pendingBounds;         // Outputs whose weight is exhausted.
+  vec<Lit> pendingSplits;         // Outputs that kept part of their weight.
+  vec<uint64_t> pendingSplitWeights;
+
   
   uint64_t min_weight;
 
   int _partitions;
   int _mode;
   int _limit;
+  int _strat; // Stratification schedule (weighted).
+  int _threads; // Workers extracting cores of partitions (unweighted).
 
-  void createPartitions();
 
   vec< vec<int> > soft_partitions;
-  vec< vec<int> > soft_partitions_tmp;
     vec<bool> activeSoftPartition;
 };
 } // namespace upmax
@@ -80,21 +80,13 @@ Solver *UpWBO::rebuildWeightSolver(int strategy) {
   if (symmetryStrategy)
     symmetryBreaking();
 
-  vec<Lit> clause;
+  solverSoft.clear();
+  solverSoft.growTo(maxsat_formula->nSoft(), false);
   nbCurrentSoft = 0;
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
     if (maxsat_formula->getSoftClause(i).weight >=
-        maxsat_formula->getMaximumWeight()) {
-      nbCurrentSoft++;
-      clause.clear();
-      maxsat_formula->getSoftClause(i).clause.copyTo(clause);
-      for (int j = 0;
-           j < maxsat_formula->getSoftClause(i).relaxation_vars.size(); j++)
-        clause.push(maxsat_formula->getSoftClause(i).relaxation_vars[j]);
-
-      clause.push(maxsat_formula->getSoftClause(i).assumption_var);
-      S->addClause(clause);
-    }
+        maxsat_formula->getMaximumWeight())
+      addSoftSolver(S, i);
   }
 
   // printf("c #PB: %d\n", maxsat_formula->nPB());
@@ -164,17 +156,11 @@ Solver *UpWBO::rebuildSolver() {
   if (symmetryStrategy)
     symmetryBreaking();
 
-  vec<Lit> clause;
-  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-    clause.clear();
-    maxsat_formula->getSoftClause(i).clause.copyTo(clause);
-    for (int j = 0; j < maxsat_formula->getSoftClause(i).relaxation_vars.size();
-         j++)
-      clause.push(maxsat_formula->getSoftClause(i).relaxation_vars[j]);
-    clause.push(maxsat_formula->getSoftClause(i).assumption_var);
-
-    S->addClause(clause);
-  }
+  solverSoft.clear();
+  solverSoft.growTo(maxsat_formula->nSoft(), false);
+  nbCurrentSoft = 0;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    addSoftSolver(S, i);
 
   // printf("c #PB: %d\n", maxsat_formula->nPB());
   for (int i = 0; i < maxsat_formula->nPB(); i++) {
@@ -481,6 +467,10 @@ void UpWBO::encodeEO(vec<Lit> &lits) {
   |  Description:
   |
   |    Relaxes the core as described in the original WBO paper.
+  |    The relaxation is added to the working formula of 'solver' instead of
+  |    rebuilding it, such that learnt clauses are kept. A relaxed soft clause
+  |    is added again with a fresh assumption literal, and the previous copy
+  |    is disabled by asserting its old assumption literal.
   |
   |  For further details see:
   |    * Vasco Manquinho, Joao Marques-Silva, Jordi Planes: Algorithms for
@@ -505,6 +495,9 @@ void UpWBO::encodeEO(vec<Lit> &lits) {
   |        clause.
   |      - 'coreMapping' is updated to map the new soft clause to its assumption
   |        literal.
+  |    * 'assumps' is updated with the assumption literals of the relaxed soft
+  |      clauses.
+  |    * 'solver' is updated with the new variables and clauses.
   |    * 'sumSizeCores' is updated.
   |
   |________________________________________________________________________________________________@*/
@@ -515,9 +508,12 @@ void UpWBO::relaxCore(const vec<Lit> &conflict, uint64_t weightCore,
   assert(weightCore > 0);
 
   vec<Lit> lits;
+  vec<int> relaxed;             // Soft clauses to be added to 'solver'.
+  std::map<Lit, Lit> disabled; // Previous assumptions of relaxed clauses.
+  int nHard = maxsat_formula->nHard();
 
   for (int i = 0; i < conflict.size(); i++) {
-    int indexSoft = coreMapping[conflict[i]];
+    int indexSoft = softIndex(conflict[i]);
 
     if (maxsat_formula->getSoftClause(indexSoft).weight == weightCore) {
       // If the weight of the soft clause is the same as the weight of the core
@@ -526,6 +522,14 @@ void UpWBO::relaxCore(const vec<Lit> &conflict, uint64_t weightCore,
       maxsat_formula->getSoftClause(indexSoft).relaxation_vars.push(p);
       lits.push(p);
 
+      // The relaxed soft clause gets a new assumption literal.
+      Lit l = maxsat_formula->newLiteral();
+      maxsat_formula->getSoftClause(indexSoft).assumption_var = l;
+      unsetCoreMapping(conflict[i]);
+      setCoreMapping(l, indexSoft);
+      disabled[~conflict[i]] = ~l;
+      relaxed.push(indexSoft);
+
       if (symmetryStrategy)
         symmetryLog(indexSoft);
     } else {
@@ -551,9 +555,10 @@ void UpWBO::relaxCore(const vec<Lit> &conflict, uint64_t weightCore,
       // Create a new assumption literal.
       maxsat_formula->getSoftClause(maxsat_formula->nSoft() - 1)
           .assumption_var = l;
-      coreMapping[l] = maxsat_formula->nSoft() -
-                       1; // Map the new soft clause to its assumption literal.
+      // Map the new soft clause to its assumption literal.
+      setCoreMapping(l, maxsat_formula->nSoft() - 1);
       assumps.push(~l);   // Update the assumption vector.
+      relaxed.push(maxsat_formula->nSoft() - 1);
 
       if (symmetryStrategy)
         symmetryLog(maxsat_formula->nSoft() - 1);
@@ -561,6 +566,60 @@ void UpWBO::relaxCore(const vec<Lit> &conflict, uint64_t weightCore,
   }
   encodeEO(lits);
   sumSizeCores += conflict.size();
+
+  if (symmetryStrategy)
+    symmetryBreaking();
+
+  // Update the working formula of 'solver'.
+  while (solver->nVars() < maxsat_formula->nVars())
+    newSATVariable(solver);
+
+  for (int i = nHard; i < maxsat_formula->nHard(); i++)
+    solver->addClause(maxsat_formula->getHardClause(i).clause);
+
+  for (int i = 0; i < relaxed.size(); i++)
+    addSoftSolver(solver, relaxed[i]);
+
+  for (std::map<Lit, Lit>::iterator it = disabled.begin();
+       it != disabled.end(); ++it)
+    solver->addClause(~it->first);
+
+  for (int i = 0; i < assumps.size(); i++) {
+    std::map<Lit, Lit>::iterator it = disabled.find(assumps[i]);
+    if (it != disabled.end())
+      assumps[i] = it->second;
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  addSoftSolver : (S : Solver *) (i : int) ->  [void]
+  |
+  |  Description:
+  |
+  |    Adds the soft clause with index 'i' to 'S', extended with its
+  |    relaxation variables and its assumption literal.
+  |
+  |  Post-conditions:
+  |    * 'solverSoft' and 'nbCurrentSoft' are updated.
+  |
+  |________________________________________________________________________________________________@*/
+void UpWBO::addSoftSolver(Solver *S, int i) {
+
+  vec<Lit> clause;
+  maxsat_formula->getSoftClause(i).clause.copyTo(clause);
+  for (int j = 0; j < maxsat_formula->getSoftClause(i).relaxation_vars.size();
+       j++)
+    clause.push(maxsat_formula->getSoftClause(i).relaxation_vars[j]);
+  clause.push(maxsat_formula->getSoftClause(i).assumption_var);
+  S->addClause(clause);
+
+  if (solverSoft.size() <= i)
+    solverSoft.growTo(i + 1, false);
+  if (!solverSoft[i]) {
+    solverSoft[i] = true;
+    nbCurrentSoft++;
+  }
 }
 
 /*_________________________________________________________________________________________________
@@ -587,7 +646,7 @@ uint64_t UpWBO::computeCostCore(const vec<Lit> &conflict) {
   uint64_t coreCost = UINT64_MAX;
 
   for (int i = 0; i < conflict.size(); i++) {
-    int indexSoft = coreMapping[conflict[i]];
+    int indexSoft = softIndex(conflict[i]);
     if (maxsat_formula->getSoftClause(indexSoft).weight < coreCost)
       coreCost = maxsat_formula->getSoftClause(indexSoft).weight;
   }
@@ -819,6 +878,7 @@ StatusCode UpWBO::unsatSearch() {
     ubCost = cost;
     saveModel(solver->model);
     printBound(ubCost);
+    improveModel(solver);
   }
 
   delete solver;
@@ -865,15 +925,17 @@ StatusCode UpWBO::weightSearch() {
 
   _current_partition = 0;
   initAssumptionsPartition(assumptions);
-  printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());  
+  if (print)
+    printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());  
 
   for (;;) {
 
     if (_limit != -1 && _current_partition+1 != _partitions)
-      solver->setConfBudget(_limit);
+      conflict_budget.start(solver, _current_partition);
     else
       solver->budgetOff();
     lbool res = searchSATSolver(solver, assumptions);
+    conflict_budget.finish(solver, res);
 
     if (res == l_False) {
       nbCores++;
@@ -884,8 +946,7 @@ StatusCode UpWBO::weightSearch() {
         printf("c LB : %-12" PRIu64 " CS : %-12d W  : %-12" PRIu64 "\n", lbCost,
                solver->conflict.size(), coreCost);
       relaxCore(solver->conflict, coreCost, assumptions);
-      delete solver;
-      solver = rebuildWeightSolver(weightStrategy);
+      hardenAssumptions();
     } else {
     if (res == l_True) {
       nbSatisfiable++;
@@ -896,6 +957,8 @@ StatusCode UpWBO::weightSearch() {
           printBound(newCost);
           ubCost = newCost;
         }
+        improveModel(solver);
+        hardenAssumptions();
 
         if (ubCost == 0){
           printAnswer(_OPTIMUM_);
@@ -908,14 +971,11 @@ StatusCode UpWBO::weightSearch() {
         return _OPTIMUM_; 
       } else {
 
-        printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());
+        if (print)
+          printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());
         initAssumptionsPartition(assumptions);
 
       }  
-
-      // do we need this rebuild?
-        delete solver;
-        solver = rebuildWeightSolver(weightStrategy);
       }
     }
   }
@@ -946,17 +1006,37 @@ StatusCode UpWBO::normalSearch() {
   initAssumptions(assumptions);
   solver = rebuildSolver();
 
+  // Lexicographic formulas are solved one weight level at a time, and the
+  // partitions are restricted to the soft clauses of the current level.
+  bool bmo = maxsat_formula->getProblemType() == _WEIGHTED_ && bmo_search &&
+             isBMO();
+  int level = 0;
+  PartitionSchedule schedule(maxsat_formula, partition_order);
+  vec<vec<int>> partitions;
+  if (bmo) {
+    soft_partitions.moveTo(partitions);
+    schedule.buildLevel(partitions, orderWeights[level], soft_partitions);
+    _partitions = soft_partitions.size();
+    if (print) {
+      printf("c Level #%d weight = %" PRIu64 "\n", level + 1,
+             orderWeights[level]);
+      printf("c #Soft Partitions = %d\n", _partitions);
+    }
+  }
+
   _current_partition = 0;
   initAssumptionsPartition(assumptions);
-  printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());
+  if (print)
+    printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());
 
   for (;;) {
 
     if (_limit != -1 && _current_partition+1 != _partitions)
-      solver->setConfBudget(_limit);
+      conflict_budget.start(solver, _current_partition);
     else
       solver->budgetOff();
     lbool res = searchSATSolver(solver, assumptions);
+    conflict_budget.finish(solver, res);
 
     if (res == l_False) {
       nbCores++;
@@ -975,8 +1055,7 @@ StatusCode UpWBO::normalSearch() {
       // }
 
       relaxCore(solver->conflict, coreCost, assumptions);
-      delete solver;
-      solver = rebuildSolver();
+      hardenAssumptions();
     } else {
       
       _current_partition++;
@@ -989,6 +1068,8 @@ StatusCode UpWBO::normalSearch() {
           printBound(newCost);
           ubCost = newCost;
         }
+        improveModel(solver);
+        hardenAssumptions();
 
         if (ubCost == 0){
           printAnswer(_OPTIMUM_);
@@ -996,12 +1077,33 @@ StatusCode UpWBO::normalSearch() {
         }
       }
 
+      // The optimum of the level is found once all of its partitions are
+      // active. Since all soft clauses of a level have the same weight, the
+      // cores only relax soft clauses of the level, and hardening the
+      // assumptions fixes its optimum.
+      if (bmo && _current_partition == _partitions &&
+          level + 1 < (int)orderWeights.size()) {
+        hardenLevel(solver, assumptions);
+        assumptions.clear();
+
+        level++;
+        schedule.buildLevel(partitions, orderWeights[level], soft_partitions);
+        _partitions = soft_partitions.size();
+        if (print) {
+          printf("c Level #%d weight = %" PRIu64 "\n", level + 1,
+                 orderWeights[level]);
+          printf("c #Soft Partitions = %d\n", _partitions);
+        }
+        _current_partition = 0;
+      }
+
       if (_current_partition == _partitions){
         printAnswer(_OPTIMUM_);
         return _OPTIMUM_; 
       } else {
 
-        printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());
+        if (print)
+          printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());
         initAssumptionsPartition(assumptions);
 
       }
@@ -1030,10 +1132,12 @@ StatusCode UpWBO::search() {
   if (symmetryStrategy)
     initSymmetry();
 
-  createPartitions();
+  PartitionSchedule schedule(maxsat_formula, partition_order);
+  schedule.build(soft_partitions);
   _activeSoftPartition.growTo(maxsat_formula->nSoft(), false);
   _partitions = soft_partitions.size();
-  printf("c #Soft Partitions = %d\n",_partitions);
+  if (print)
+    printf("c #Soft Partitions = %d\n",_partitions);
 
   if (maxsat_formula->getProblemType() == _UNWEIGHTED_ ||
       weightStrategy == _WEIGHT_NONE_)
@@ -1074,49 +1178,30 @@ void UpWBO::initAssumptions(vec<Lit> &assumps) {
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
     Lit l = maxsat_formula->newLiteral();
     maxsat_formula->getSoftClause(i).assumption_var = l;
-    coreMapping[l] = i;
+    setCoreMapping(l, i);
     //assumps.push(~l);
   }
 }
 
 void UpWBO::initAssumptionsPartition(vec<Lit> &assumps){
     for (int i = 0; i < soft_partitions[_current_partition].size(); i++){
-      assumptions.push(~maxsat_formula->getSoftClause(soft_partitions[_current_partition][i]).assumption_var);
+      if (!isHardened(soft_partitions[_current_partition][i]))
+        assumptions.push(~maxsat_formula->getSoftClause(soft_partitions[_current_partition][i]).assumption_var);
     }
 }
 
-void UpWBO::createPartitions() {
-  _partitions = 0;
-
-  for (int i = 0; i < maxsat_formula->nPartitions()+1; i++){
-    soft_partitions_tmp.push();
-    new (&soft_partitions_tmp[i]) vec<int>();
-  }
-
-  for (int i = 0; i < maxsat_formula->nSoft(); i++){
-    int v = maxsat_formula->getSoftClause(i).getPartition();
-    if (v == -1) v = maxsat_formula->nPartitions();
-    assert (v >= 0 && v < soft_partitions_tmp.size());
-    soft_partitions_tmp[v].push(i);
-  }  
-
-  std::vector< pair <int,int> > vect;
-  for (int i = 0; i < soft_partitions_tmp.size(); i++){
-    vect.push_back( std::make_pair(soft_partitions_tmp[i].size(), i) );
-  }
-
-  std::sort(vect.begin(), vect.end());
-  for (int i = 0; i < vect.size(); i++){
-    if (vect[i].first > 0){
-      soft_partitions.push();
-      new (&soft_partitions[soft_partitions.size()-1]) vec<int>();
-      for (int j = 0; j < soft_partitions_tmp[vect[i].second].size(); j++){
-        int v = soft_partitions_tmp[vect[i].second][j];
-        soft_partitions[soft_partitions.size()-1].push(v);
-      }
-      soft_partitions_tmp[vect[i].second].clear();
-    } else soft_partitions_tmp[vect[i].second].clear();
-  }
-  soft_partitions_tmp.clear();
-
-}
\ No newline at end of file
+// Hardens the soft clauses whose weight exceeds the gap between the bounds
+// (see 'hardenSoftClauses') and removes them from the assumptions. Since
+// relaxed soft clauses keep their weight, all soft clauses are considered.
+void UpWBO::hardenAssumptions() {
+  vec<Lit> units;
+  hardenSoftClauses(solver, lbCost, units);
+  if (units.size() == 0)
+    return;
+
+  int j = 0;
+  for (int i = 0; i < assumptions.size(); i++)
+    if (!isHardened(softIndex(~assumptions[i])))
+      assumptions[j++] = assumptions[i];
+  assumptions.shrink(assumptions.size() - j);
+}
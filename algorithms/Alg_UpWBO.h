@@ -32,6 +32,7 @@
 #include "core/Solver.h"
 
 #include "../Encoder.h"
+#include "../PartitionSchedule.h"
 #include "../MaxSAT_Partition.h"
 #include "../MaxTypes.h"
 #include "utils/System.h"
@@ -58,7 +59,9 @@ public:
     symmetryBreakingLimit = 500000; // old limit
 
     _current_partition = 0;
+    _mode = mode;
     _limit = limit;
+    conflict_budget.setLimit(limit);
   }
 
   ~UpWBO() {
@@ -104,6 +107,7 @@ protected:
   void encodeEO(vec<Lit> &lits); // Encodes exactly one constraint.
   void relaxCore(const vec<Lit> &conflict, uint64_t weightCore,
                  vec<Lit> &assumps);            // Relaxes a core.
+  void addSoftSolver(Solver *S, int i); // Adds a soft clause to 'S'.
   uint64_t computeCostCore(const vec<Lit> &conflict); // Computes the cost of a core.
 
   // Symmetry breaking methods
@@ -131,11 +135,10 @@ protected:
   int nbCurrentSoft;  // Current number of soft clauses used by the MaxSAT
                       // solver.
   int weightStrategy; // Weight strategy to be used in 'weightSearch'.
+  vec<bool> solverSoft; // Soft clauses in the working formula of 'solver'.
 
   // Core extraction
   //
-  std::map<Lit, int> coreMapping; // Maps the assumption literal to the number
-                                  // of the soft clause.
   vec<Lit> assumptions; // Stores the assumptions to be used in the extraction
                         // of the core.
 
@@ -155,14 +158,14 @@ protected:
                                                       // duplication).
   int symmetryBreakingLimit; // Limit on the number of symmetry clauses.
 
-  void createPartitions();
   vec<bool> _activeSoftPartition;
   int _current_partition;
   int _partitions;
 
   vec< vec<int> > soft_partitions;
-  vec< vec<int> > soft_partitions_tmp;
   void initAssumptionsPartition(vec<Lit> &assumps);
+  void hardenAssumptions();
+  int _mode;
   int _limit;
 
 };
@@ -57,27 +57,30 @@ StatusCode UpWMSU3::UpWMSU3_none()
   lbool res = l_True;
 
   initRelaxation();
+  reachableCosts.clear();
   solver = rebuildSolver();
   encoder.setIncremental(_INCREMENTAL_NONE_);
 
   activeSoft.growTo(maxsat_formula->nSoft(), false);
-  for (int i = 0; i < maxsat_formula->nSoft(); i++)
-    coreMapping[maxsat_formula->getSoftClause(i).assumption_var] = i;
 
+  objFunction.clear();
+  coeffs.clear();
   assumptions.clear();
 
   _current_partition = 0;
   initAssumptionsPartition(assumptions);
-  printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());
+  if (print)
+    printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());
 
   for (;;)
   {
 
     if (_limit != -1 && _current_partition+1 != _partitions)
-      solver->setConfBudget(_limit);
+      conflict_budget.start(solver, _current_partition);
     else
       solver->budgetOff();
-    res = searchSATSolver(solver, assumptions);
+    res = searchSATSolver(solver, assumptions.lits());
+    conflict_budget.finish(solver, res);
     if (res != l_False)
     {
       if (res == l_True){
@@ -86,9 +89,11 @@ StatusCode UpWMSU3::UpWMSU3_none()
         if (newCost < ubCost || nbSatisfiable == 1)
         {
           saveModel(solver->model);
-          printf("o %" PRIu64 "\n", newCost);
+          printBound(newCost);
           ubCost = newCost;
         }
+        improveModel(solver);
+        hardenAssumptions();
 
         if (ubCost == 0)
           //|| lbCost == ubCost ||
@@ -111,7 +116,8 @@ StatusCode UpWMSU3::UpWMSU3_none()
         return _OPTIMUM_; 
       } else {
 
-        printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());
+        if (print)
+          printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());
         initAssumptionsPartition(assumptions);
 
       }
@@ -142,26 +148,16 @@ StatusCode UpWMSU3::UpWMSU3_none()
 
       for (int i = 0; i < solver->conflict.size(); i++)
       {
-        int index_soft = coreMapping[solver->conflict[i]];
+        int index_soft = softIndex(solver->conflict[i]);
         assert(!activeSoft[index_soft]);
         activeSoft[index_soft] = true;
-      }
+        reachableCosts.add(maxsat_formula->getSoftClause(index_soft).weight);
 
-      objFunction.clear();
-      coeffs.clear();
-      assumptions.clear();
-      for (int i = 0; i < maxsat_formula->nSoft(); i++)
-      {
-        // If a soft clause is active then is added to the 'currentObjFunction'
-        if (activeSoft[i])
-        {
-          objFunction.push(maxsat_formula->getSoftClause(i).relaxation_vars[0]);
-          coeffs.push(maxsat_formula->getSoftClause(i).weight);
-        }
-        // Otherwise, the soft clause is not relaxed and the assumption is used
-        // to get an unsat core.
-        else if (maxsat_formula->getSoftClause(i).weight >= currentWeight && _activeSoftPartition[i])
-          assumptions.push(~maxsat_formula->getSoftClause(i).assumption_var);
+        // The relaxed soft clause is added to the objective function and
+        // its assumption is no longer used to get an unsat core.
+        objFunction.push(maxsat_formula->getSoftClause(index_soft).relaxation_vars[0]);
+        coeffs.push(maxsat_formula->getSoftClause(index_soft).weight);
+        assumptions.remove(~maxsat_formula->getSoftClause(index_soft).assumption_var);
       }
 
       if (verbosity > 0)
@@ -170,14 +166,162 @@ StatusCode UpWMSU3::UpWMSU3_none()
       delete solver;
       solver = rebuildSolver();
 
-      lbCost++;
-      while (!subsetSum(coeffs, lbCost))
+      lbCost = reachableCosts.next(lbCost + 1);
+
+      if (verbosity > 0) printf("c LB : %-12" PRIu64 "\n", lbCost);
+      encoder.encodePB(solver, objFunction, coeffs, lbCost);
+    }
+  }
+
+  return _ERROR_;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  UpWMSU3_iterative : [void] ->  [void]
+  |
+  |  Description:
+  |
+  |    Incremental iterative encoding for the UpWMSU3 algorithm.
+  |    Uses a single SAT solver. The PB constraint over the relaxed soft
+  |    clauses is built with the SWC encoding and extended with the soft
+  |    clauses of each new core, while the right-hand side is increased to
+  |    the new lower bound and enforced with assumptions.
+  |
+  |  For further details see:
+  |    *  Ruben Martins, Saurabh Joshi, Vasco M. Manquinho, Inês Lynce:
+  |       Incremental Cardinality Constraints for MaxSAT. CP 2014: 531-548
+  |
+  |  Pre-conditions:
+  |    * Assumes SWC is used as the PB encoding.
+  |
+  |  Post-conditions:
+  |    * 'ubCost' is updated.
+  |    * 'lbCost' is updated.
+  |    * 'nbSatisfiable' is updated.
+  |    * 'nbCores' is updated.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode UpWMSU3::UpWMSU3_iterative()
+{
+  lbool res = l_True;
+
+  initRelaxation();
+  reachableCosts.clear();
+  solver = rebuildSolver();
+  encoder.setIncremental(_INCREMENTAL_ITERATIVE_);
+
+  activeSoft.growTo(maxsat_formula->nSoft(), false);
+
+  vec<Lit> joinObjFunction;
+  vec<uint64_t> joinCoeffs;
+  vec<Lit> encodingAssumptions;
+
+  objFunction.clear();
+  coeffs.clear();
+  assumptions.clear();
+
+  _current_partition = 0;
+  initAssumptionsPartition(assumptions);
+  if (print)
+    printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());
+
+  for (;;)
+  {
+
+    if (_limit != -1 && _current_partition+1 != _partitions)
+      conflict_budget.start(solver, _current_partition);
+    else
+      solver->budgetOff();
+    res = searchSATSolver(solver, assumptions.lits());
+    conflict_budget.finish(solver, res);
+    if (res != l_False)
+    {
+      if (res == l_True){
+        nbSatisfiable++;
+        uint64_t newCost = computeCostModel(solver->model);
+        if (newCost < ubCost || nbSatisfiable == 1)
+        {
+          saveModel(solver->model);
+          printBound(newCost);
+          ubCost = newCost;
+        }
+        improveModel(solver);
+        hardenAssumptions();
+
+        if (ubCost == 0)
+        {
+          printAnswer(_OPTIMUM_);
+          return _OPTIMUM_;
+        }
+      }
+
+      _current_partition++;
+
+      if (_current_partition == _partitions){
+        printAnswer(_OPTIMUM_);
+        return _OPTIMUM_;
+      } else {
+
+        if (print)
+          printf("c Partition #%d= %d\n",_current_partition+1,soft_partitions[_current_partition].size());
+        initAssumptionsPartition(assumptions);
+
+      }
+
+    } else {
+
+      nbCores++;
+      sumSizeCores += solver->conflict.size();
+
+      if (solver->conflict.size() == 0)
       {
-        lbCost++;
+        printAnswer(_UNSATISFIABLE_);
+        return _UNSATISFIABLE_;
       }
 
+      // The core may also contain assumptions of the PB encoding, including
+      // relaxed soft clauses that were not encoded yet.
+      joinObjFunction.clear();
+      joinCoeffs.clear();
+      for (int i = 0; i < solver->conflict.size(); i++)
+      {
+        int index_soft = softIndex(solver->conflict[i]);
+        if (index_soft == -1)
+          continue;
+        if (activeSoft[index_soft])
+          continue;
+        activeSoft[index_soft] = true;
+        reachableCosts.add(maxsat_formula->getSoftClause(index_soft).weight);
+        joinObjFunction.push(maxsat_formula->getSoftClause(index_soft).relaxation_vars[0]);
+        joinCoeffs.push(maxsat_formula->getSoftClause(index_soft).weight);
+        objFunction.push(maxsat_formula->getSoftClause(index_soft).relaxation_vars[0]);
+        coeffs.push(maxsat_formula->getSoftClause(index_soft).weight);
+        assumptions.remove(~maxsat_formula->getSoftClause(index_soft).assumption_var);
+      }
+
+      if (verbosity > 0)
+        printf("c Relaxed soft clauses %d / %d\n", objFunction.size(), maxsat_formula->nSoft());
+
+      lbCost = reachableCosts.next(lbCost + 1);
+
       if (verbosity > 0) printf("c LB : %-12" PRIu64 "\n", lbCost);
-      encoder.encodePB(solver, objFunction, coeffs, lbCost);
+
+      // While the encoding is not built, the previously relaxed soft clauses
+      // are kept by the encoder and only the new ones are given.
+      encodingAssumptions.clear();
+      if (!encoder.hasPBEncoding())
+        encoder.incEncodePB(solver, joinObjFunction, joinCoeffs, lbCost,
+                            encodingAssumptions, maxsat_formula->nSoft());
+      else
+      {
+        encoder.incUpdatePB(solver, joinObjFunction, joinCoeffs, lbCost,
+                            encodingAssumptions);
+        encodingAssumptions.clear();
+        encoder.incUpdatePBAssumptions(solver, encodingAssumptions);
+      }
+
+      assumptions.setTail(encodingAssumptions);
     }
   }
 
@@ -199,11 +343,16 @@ StatusCode UpWMSU3::search()
   printConfiguration();
   if (!is_bmo) currentWeight = 1; // No weight strategy none.
 
-  createPartitions();
+  PartitionSchedule schedule(maxsat_formula, partition_order);
+  schedule.build(soft_partitions);
   _activeSoftPartition.growTo(maxsat_formula->nSoft(), false);
   _partitions = soft_partitions.size();
-  printf("c #Soft Partitions = %d\n",_partitions);
+  if (print)
+    printf("c #Soft Partitions = %d\n",_partitions);
 
+  if (incremental_strategy == _INCREMENTAL_ITERATIVE_ &&
+      encoder.getPBEncoding() == _PB_SWC_)
+    return UpWMSU3_iterative();
   return UpWMSU3_none();
 }
 
@@ -244,6 +393,9 @@ Solver *UpWMSU3::rebuildSolver()
     S->addClause(clause);
   }
 
+  // Soft clauses hardened before a core rebuilt the solver.
+  addHardened(S);
+
   return S;
 }
 
@@ -274,96 +426,28 @@ void UpWMSU3::initRelaxation()
     Lit l = maxsat_formula->newLiteral();
     maxsat_formula->getSoftClause(i).relaxation_vars.push(l);
     maxsat_formula->getSoftClause(i).assumption_var = l;
+    setCoreMapping(l, i);
   }
 }
 
-void UpWMSU3::initAssumptionsPartition(vec<Lit> &assumps){
+void UpWMSU3::initAssumptionsPartition(AssumptionSet &assumps){
     for (int i = 0; i < soft_partitions[_current_partition].size(); i++){
-      if (!activeSoft[soft_partitions[_current_partition][i]])
-        assumptions.push(~maxsat_formula->getSoftClause(soft_partitions[_current_partition][i]).assumption_var);
+      if (!activeSoft[soft_partitions[_current_partition][i]] &&
+          !isHardened(soft_partitions[_current_partition][i]))
+        assumps.add(~maxsat_formula->getSoftClause(soft_partitions[_current_partition][i]).assumption_var);
       _activeSoftPartition[soft_partitions[_current_partition][i]] = true;
     }
 }
 
 
-void UpWMSU3::createPartitions() {
-  _partitions = 0;
-
-  for (int i = 0; i < maxsat_formula->nPartitions()+1; i++){
-    soft_partitions_tmp.push();
-    new (&soft_partitions_tmp[i]) vec<int>();
-  }
-
-  for (int i = 0; i < maxsat_formula->nSoft(); i++){
-    int v = maxsat_formula->getSoftClause(i).getPartition();
-    if (v == -1) v = maxsat_formula->nPartitions();
-    assert (v >= 0 && v < soft_partitions_tmp.size());
-    soft_partitions_tmp[v].push(i);
-  }  
-
-  std::vector< std::pair <int,int> > vect;
-  for (int i = 0; i < soft_partitions_tmp.size(); i++){
-    vect.push_back( std::make_pair(soft_partitions_tmp[i].size(), i) );
-  }
-
-  std::sort(vect.begin(), vect.end());
-  for (int i = 0; i < vect.size(); i++){
-    if (vect[i].first > 0){
-      soft_partitions.push();
-      new (&soft_partitions[soft_partitions.size()-1]) vec<int>();
-      for (int j = 0; j < soft_partitions_tmp[vect[i].second].size(); j++){
-        int v = soft_partitions_tmp[vect[i].second][j];
-        soft_partitions[soft_partitions.size()-1].push(v);
-      }
-      soft_partitions_tmp[vect[i].second].clear();
-    } else soft_partitions_tmp[vect[i].second].clear();
-  }
-  soft_partitions_tmp.clear();
-
-}
-
-// Returns true if there is a subset of set[] with sum equal to given sum
-bool UpWMSU3::subsetSum(vec<uint64_t> &set, int64_t sum)
-{
-  int n = set.size();
-  
-  // Declaring the array dynamically to avoid stack frame limit
-  bool ** subset = new bool*[sum+1];
-  for (int i = 0; i <= sum; i++)
-    subset[i] = new bool[n+1];
-
-  // The value of subset[i][j] will be true if there is a subset of set[0..j-1]
-  //  with sum equal to i
-  
-  // If sum is 0, then answer is true
-  for (int i = 0; i <= n; i++)
-  {
-    //assert (i < n+1);
-    //printf("i %d\n",i);
-    subset[0][i] = true;
-  }
-
-  // If sum is not 0 and set is empty, then answer is false
-  for (int i = 1; i <= sum; i++)
-    subset[i][0] = false;
-
-  // Fill the subset table in bottom up manner
-  for (int i = 1; i <= sum; i++)
-  {
-    for (int j = 1; j <= n; j++)
-    {
-      subset[i][j] = subset[i][j - 1];
-      if (i >= set[j - 1])
-        subset[i][j] = subset[i][j] || subset[i - set[j - 1]][j - 1];
-    }
-  }
-
-  bool is_subset = subset[sum][n];
-  for (int i = 0; i <= sum; i++)
-    delete [] subset[i];
-  delete [] subset;
-
-  return is_subset;
+// Hardens the soft clauses whose weight exceeds the cost of the best model
+// (see 'hardenSoftClauses'). The lower bound only holds for the relaxed soft
+// clauses as a whole, so it cannot be added to the weight of a soft clause.
+void UpWMSU3::hardenAssumptions() {
+  vec<Lit> units;
+  hardenSoftClauses(solver, 0, units);
+  for (int i = 0; i < units.size(); i++)
+    assumptions.remove(units[i]);
 }
 
 // Print WSMU3 configuration.
@@ -32,7 +32,10 @@
 #include "core/Solver.h"
 
 #include "../MaxSAT.h"
+#include "../AssumptionSet.h"
 #include "../Encoder.h"
+#include "../SubsetSum.h"
+#include "../PartitionSchedule.h"
 #include <vector>
 #include <map>
 #include <set>
@@ -58,6 +61,7 @@ public:
     bmo_strategy = bmo;
     is_bmo = false;
     currentWeight = 1;
+    _limit = -1;
   }
   ~UpWMSU3()
   {
@@ -90,12 +94,11 @@ protected:
   // Search methods
   //
   StatusCode UpWMSU3_none();
+  StatusCode UpWMSU3_iterative();
   
   // Other
   //
   void initRelaxation(); // Relaxes soft clauses.
-  // subsetsum with dynamic programming.
-  bool subsetSum(vec<uint64_t> &set, int64_t num);
   void print_UpWMSU3_configuration(); // Print WSMU3 configuration.
 
   Solver *solver;  // SAT Solver used as a black box.
@@ -106,15 +109,13 @@ protected:
   int encoding; // Controls the cardinality encoding used by MSU3 algorithms.
 
   int weightStrategy;   // Weight strategy to be used in 'weightSearch'.
-  vec<Lit> assumptions; // Assumptions used in the SAT solver.
+  AssumptionSet assumptions; // Assumptions used in the SAT solver.
 
   // Literals to be used in the constraint that excludes models.
   vec<Lit> objFunction;
   vec<uint64_t> coeffs; // Coefficients of the literals that are used in the
                    // constraint that excludes models.
-
-  std::map<Lit, int> coreMapping; // Mapping between the assumption literal and
-                                  // the respective soft clause.
+  SubsetSum reachableCosts; // Costs reachable by the coefficients.
 
   // Soft clauses that are currently in the MaxSAT formula.
   vec<bool> activeSoft;
@@ -127,14 +128,13 @@ protected:
   vec<Lit> unit_bmo;
   uint64_t currentWeight;
 
-  void createPartitions();
   vec<bool> _activeSoftPartition;
   int _current_partition;
   int _partitions;
 
   vec< vec<int> > soft_partitions;
-  vec< vec<int> > soft_partitions_tmp;
-  void initAssumptionsPartition(vec<Lit> &assumps);
+  void initAssumptionsPartition(AssumptionSet &assumps);
+  void hardenAssumptions();
   int _limit;
 };
 }
@@ -80,21 +80,13 @@ Solver *WBO::rebuildWeightSolver(int strategy) {
   if (symmetryStrategy)
     symmetryBreaking();
 
-  vec<Lit> clause;
+  solverSoft.clear();
+  solverSoft.growTo(maxsat_formula->nSoft(), false);
   nbCurrentSoft = 0;
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
     if (maxsat_formula->getSoftClause(i).weight >=
-        maxsat_formula->getMaximumWeight()) {
-      nbCurrentSoft++;
-      clause.clear();
-      maxsat_formula->getSoftClause(i).clause.copyTo(clause);
-      for (int j = 0;
-           j < maxsat_formula->getSoftClause(i).relaxation_vars.size(); j++)
-        clause.push(maxsat_formula->getSoftClause(i).relaxation_vars[j]);
-
-      clause.push(maxsat_formula->getSoftClause(i).assumption_var);
-      S->addClause(clause);
-    }
+        maxsat_formula->getMaximumWeight())
+      addSoftSolver(S, i);
   }
 
   // printf("c #PB: %d\n", maxsat_formula->nPB());
@@ -164,17 +156,11 @@ Solver *WBO::rebuildSolver() {
   if (symmetryStrategy)
     symmetryBreaking();
 
-  vec<Lit> clause;
-  for (int i = 0; i < maxsat_formula->nSoft(); i++) {
-    clause.clear();
-    maxsat_formula->getSoftClause(i).clause.copyTo(clause);
-    for (int j = 0; j < maxsat_formula->getSoftClause(i).relaxation_vars.size();
-         j++)
-      clause.push(maxsat_formula->getSoftClause(i).relaxation_vars[j]);
-    clause.push(maxsat_formula->getSoftClause(i).assumption_var);
-
-    S->addClause(clause);
-  }
+  solverSoft.clear();
+  solverSoft.growTo(maxsat_formula->nSoft(), false);
+  nbCurrentSoft = 0;
+  for (int i = 0; i < maxsat_formula->nSoft(); i++)
+    addSoftSolver(S, i);
 
   // printf("c #PB: %d\n", maxsat_formula->nPB());
   for (int i = 0; i < maxsat_formula->nPB(); i++) {
@@ -484,6 +470,10 @@ void WBO::encodeEO(vec<Lit> &lits) {
   |  Description:
   |
   |    Relaxes the core as described in the original WBO paper.
+  |    The relaxation is added to the working formula of 'solver' instead of
+  |    rebuilding it, such that learnt clauses are kept. A relaxed soft clause
+  |    is added again with a fresh assumption literal, and the previous copy
+  |    is disabled by asserting its old assumption literal.
   |
   |  For further details see:
   |    * Vasco Manquinho, Joao Marques-Silva, Jordi Planes: Algorithms for
@@ -508,6 +498,9 @@ void WBO::encodeEO(vec<Lit> &lits) {
   |        clause.
   |      - 'coreMapping' is updated to map the new soft clause to its assumption
   |        literal.
+  |    * 'assumps' is updated with the assumption literals of the relaxed soft
+  |      clauses.
+  |    * 'solver' is updated with the new variables and clauses.
   |    * 'sumSizeCores' is updated.
   |
   |________________________________________________________________________________________________@*/
@@ -518,9 +511,12 @@ void WBO::relaxCore(const vec<Lit> &conflict, uint64_t weightCore,
   assert(weightCore > 0);
 
   vec<Lit> lits;
+  vec<int> relaxed;             // Soft clauses to be added to 'solver'.
+  std::map<Lit, Lit> disabled; // Previous assumptions of relaxed clauses.
+  int nHard = maxsat_formula->nHard();
 
   for (int i = 0; i < conflict.size(); i++) {
-    int indexSoft = coreMapping[conflict[i]];
+    int indexSoft = softIndex(conflict[i]);
 
     if (maxsat_formula->getSoftClause(indexSoft).weight == weightCore) {
       // If the weight of the soft clause is the same as the weight of the core
@@ -529,6 +525,14 @@ void WBO::relaxCore(const vec<Lit> &conflict, uint64_t weightCore,
       maxsat_formula->getSoftClause(indexSoft).relaxation_vars.push(p);
       lits.push(p);
 
+      // The relaxed soft clause gets a new assumption literal.
+      Lit l = maxsat_formula->newLiteral();
+      maxsat_formula->getSoftClause(indexSoft).assumption_var = l;
+      unsetCoreMapping(conflict[i]);
+      setCoreMapping(l, indexSoft);
+      disabled[~conflict[i]] = ~l;
+      relaxed.push(indexSoft);
+
       if (symmetryStrategy)
         symmetryLog(indexSoft);
     } else {
@@ -554,9 +558,10 @@ void WBO::relaxCore(const vec<Lit> &conflict, uint64_t weightCore,
       // Create a new assumption literal.
       maxsat_formula->getSoftClause(maxsat_formula->nSoft() - 1)
           .assumption_var = l;
-      coreMapping[l] = maxsat_formula->nSoft() -
-                       1; // Map the new soft clause to its assumption literal.
+      // Map the new soft clause to its assumption literal.
+      setCoreMapping(l, maxsat_formula->nSoft() - 1);
       assumps.push(~l);   // Update the assumption vector.
+      relaxed.push(maxsat_formula->nSoft() - 1);
 
       if (symmetryStrategy)
         symmetryLog(maxsat_formula->nSoft() - 1);
@@ -564,6 +569,60 @@ void WBO::relaxCore(const vec<Lit> &conflict, uint64_t weightCore,
   }
   encodeEO(lits);
   sumSizeCores += conflict.size();
+
+  if (symmetryStrategy)
+    symmetryBreaking();
+
+  // Update the working formula of 'solver'.
+  while (solver->nVars() < maxsat_formula->nVars())
+    newSATVariable(solver);
+
+  for (int i = nHard; i < maxsat_formula->nHard(); i++)
+    solver->addClause(maxsat_formula->getHardClause(i).clause);
+
+  for (int i = 0; i < relaxed.size(); i++)
+    addSoftSolver(solver, relaxed[i]);
+
+  for (std::map<Lit, Lit>::iterator it = disabled.begin();
+       it != disabled.end(); ++it)
+    solver->addClause(~it->first);
+
+  for (int i = 0; i < assumps.size(); i++) {
+    std::map<Lit, Lit>::iterator it = disabled.find(assumps[i]);
+    if (it != disabled.end())
+      assumps[i] = it->second;
+  }
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  addSoftSolver : (S : Solver *) (i : int) ->  [void]
+  |
+  |  Description:
+  |
+  |    Adds the soft clause with index 'i' to 'S', extended with its
+  |    relaxation variables and its assumption literal.
+  |
+  |  Post-conditions:
+  |    * 'solverSoft' and 'nbCurrentSoft' are updated.
+  |
+  |________________________________________________________________________________________________@*/
+void WBO::addSoftSolver(Solver *S, int i) {
+
+  vec<Lit> clause;
+  maxsat_formula->getSoftClause(i).clause.copyTo(clause);
+  for (int j = 0; j < maxsat_formula->getSoftClause(i).relaxation_vars.size();
+       j++)
+    clause.push(maxsat_formula->getSoftClause(i).relaxation_vars[j]);
+  clause.push(maxsat_formula->getSoftClause(i).assumption_var);
+  S->addClause(clause);
+
+  if (solverSoft.size() <= i)
+    solverSoft.growTo(i + 1, false);
+  if (!solverSoft[i]) {
+    solverSoft[i] = true;
+    nbCurrentSoft++;
+  }
 }
 
 /*_________________________________________________________________________________________________
@@ -590,7 +649,7 @@ uint64_t WBO::computeCostCore(const vec<Lit> &conflict) {
   uint64_t coreCost = UINT64_MAX;
 
   for (int i = 0; i < conflict.size(); i++) {
-    int indexSoft = coreMapping[conflict[i]];
+    int indexSoft = softIndex(conflict[i]);
     if (maxsat_formula->getSoftClause(indexSoft).weight < coreCost)
       coreCost = maxsat_formula->getSoftClause(indexSoft).weight;
   }
@@ -879,8 +938,6 @@ StatusCode WBO::weightSearch() {
         printf("c LB : %-12" PRIu64 " CS : %-12d W  : %-12" PRIu64 "\n", lbCost,
                solver->conflict.size(), coreCost);
       relaxCore(solver->conflict, coreCost, assumptions);
-      delete solver;
-      solver = rebuildWeightSolver(weightStrategy);
     }
 
     if (res == l_True) {
@@ -912,8 +969,12 @@ StatusCode WBO::weightSearch() {
           return _OPTIMUM_;
         }
 
-        delete solver;
-        solver = rebuildWeightSolver(weightStrategy);
+        // Soft clauses of the new weight are added to the working formula.
+        for (int i = 0; i < maxsat_formula->nSoft(); i++) {
+          if (!solverSoft[i] && maxsat_formula->getSoftClause(i).weight >=
+                                    maxsat_formula->getMaximumWeight())
+            addSoftSolver(solver, i);
+        }
       }
     }
   }
@@ -966,8 +1027,6 @@ StatusCode WBO::normalSearch() {
       }
 
       relaxCore(solver->conflict, coreCost, assumptions);
-      delete solver;
-      solver = rebuildSolver();
     }
 
     if (res == l_True) {
@@ -1039,7 +1098,7 @@ void WBO::initAssumptions(vec<Lit> &assumps) {
   for (int i = 0; i < maxsat_formula->nSoft(); i++) {
     Lit l = maxsat_formula->newLiteral();
     maxsat_formula->getSoftClause(i).assumption_var = l;
-    coreMapping[l] = i;
+    setCoreMapping(l, i);
     assumps.push(~l);
   }
 }
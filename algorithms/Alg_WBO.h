@@ -105,6 +105,7 @@ protected:
   void encodeEO(vec<Lit> &lits); // Encodes exactly one constraint.
   void relaxCore(const vec<Lit> &conflict, uint64_t weightCore,
                  vec<Lit> &assumps);            // Relaxes a core.
+  void addSoftSolver(Solver *S, int i); // Adds a soft clause to 'S'.
   uint64_t computeCostCore(const vec<Lit> &conflict); // Computes the cost of a core.
 
   // Symmetry breaking methods
@@ -132,11 +133,10 @@ protected:
   int nbCurrentSoft;  // Current number of soft clauses used by the MaxSAT
                       // solver.
   int weightStrategy; // Weight strategy to be used in 'weightSearch'.
+  vec<bool> solverSoft; // Soft clauses in the working formula of 'solver'.
 
   // Core extraction
   //
-  std::map<Lit, int> coreMapping; // Maps the assumption literal to the number
-                                  // of the soft clause.
   vec<Lit> assumptions; // Stores the assumptions to be used in the extraction
                         // of the core.
 
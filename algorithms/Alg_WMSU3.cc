@@ -57,12 +57,11 @@ StatusCode WMSU3::WMSU3_none()
   lbool res = l_True;
 
   initRelaxation();
+  reachableCosts.clear();
   solver = rebuildSolver();
   encoder.setIncremental(_INCREMENTAL_NONE_);
 
   activeSoft.growTo(maxsat_formula->nSoft(), false);
-  for (int i = 0; i < maxsat_formula->nSoft(); i++)
-    coreMapping[maxsat_formula->getSoftClause(i).assumption_var] = i;
 
   assumptions.clear();
   for (;;)
@@ -75,7 +74,7 @@ StatusCode WMSU3::WMSU3_none()
       if (newCost < ubCost || nbSatisfiable == 1)
       {
         saveModel(solver->model);
-        printf("o %" PRIu64 "\n", newCost);
+        printBound(newCost);
         ubCost = newCost;
       }
 
@@ -84,7 +83,7 @@ StatusCode WMSU3::WMSU3_none()
       {
         assert(nbSatisfiable > 0);
         printAnswer(_OPTIMUM_);
-        exit(_OPTIMUM_);
+        return _OPTIMUM_;
       }
 
       for (int i = 0; i < maxsat_formula->nSoft(); i++)
@@ -101,7 +100,7 @@ StatusCode WMSU3::WMSU3_none()
       if (nbSatisfiable == 0)
       {
         printAnswer(_UNSATISFIABLE_);
-        exit(_UNSATISFIABLE_);
+        return _UNSATISFIABLE_;
       }
 
       if (lbCost == ubCost)
@@ -109,7 +108,7 @@ StatusCode WMSU3::WMSU3_none()
         assert(nbSatisfiable > 0); // Otherwise, the problem is UNSAT.
         if (verbosity > 0) printf("c LB = UB\n");
         printAnswer(_OPTIMUM_);
-        exit(_OPTIMUM_);
+        return _OPTIMUM_;
       }
 
       sumSizeCores += solver->conflict.size();
@@ -118,9 +117,10 @@ StatusCode WMSU3::WMSU3_none()
 
       for (int i = 0; i < solver->conflict.size(); i++)
       {
-        int index_soft = coreMapping[solver->conflict[i]];
+        int index_soft = softIndex(solver->conflict[i]);
         assert(!activeSoft[index_soft]);
         activeSoft[index_soft] = true;
+        reachableCosts.add(maxsat_formula->getSoftClause(index_soft).weight);
       }
 
       objFunction.clear();
@@ -146,14 +146,153 @@ StatusCode WMSU3::WMSU3_none()
       delete solver;
       solver = rebuildSolver();
 
-      lbCost++;
-      while (!subsetSum(coeffs, lbCost))
+      lbCost = reachableCosts.next(lbCost + 1);
+
+      if (verbosity > 0) printf("c LB : %-12" PRIu64 "\n", lbCost);
+      encoder.encodePB(solver, objFunction, coeffs, lbCost);
+    }
+  }
+
+  return _ERROR_;
+}
+
+/*_________________________________________________________________________________________________
+  |
+  |  WMSU3_iterative : [void] ->  [void]
+  |
+  |  Description:
+  |
+  |    Incremental iterative encoding for the WMSU3 algorithm.
+  |    Uses a single SAT solver. The PB constraint over the relaxed soft
+  |    clauses is built with the SWC encoding and extended with the soft
+  |    clauses of each new core, while the right-hand side is increased to
+  |    the new lower bound and enforced with assumptions.
+  |
+  |  For further details see:
+  |    *  Ruben Martins, Saurabh Joshi, Vasco M. Manquinho, Inês Lynce:
+  |       Incremental Cardinality Constraints for MaxSAT. CP 2014: 531-548
+  |
+  |  Pre-conditions:
+  |    * Assumes SWC is used as the PB encoding.
+  |
+  |  Post-conditions:
+  |    * 'ubCost' is updated.
+  |    * 'lbCost' is updated.
+  |    * 'nbSatisfiable' is updated.
+  |    * 'nbCores' is updated.
+  |
+  |________________________________________________________________________________________________@*/
+StatusCode WMSU3::WMSU3_iterative()
+{
+  lbool res = l_True;
+
+  initRelaxation();
+  reachableCosts.clear();
+  solver = rebuildSolver();
+  encoder.setIncremental(_INCREMENTAL_ITERATIVE_);
+
+  activeSoft.growTo(maxsat_formula->nSoft(), false);
+
+  vec<Lit> joinObjFunction;
+  vec<uint64_t> joinCoeffs;
+  vec<Lit> encodingAssumptions;
+
+  objFunction.clear();
+  coeffs.clear();
+  assumptions.clear();
+  for (;;)
+  {
+    res = searchSATSolver(solver, assumptions);
+    if (res == l_True)
+    {
+      nbSatisfiable++;
+      uint64_t newCost = computeCostModel(solver->model);
+      if (newCost < ubCost || nbSatisfiable == 1)
       {
-        lbCost++;
+        saveModel(solver->model);
+        printBound(newCost);
+        ubCost = newCost;
       }
 
+      if (ubCost == 0 || lbCost == ubCost ||
+          (currentWeight == 1 && nbSatisfiable > 1))
+      {
+        assert(nbSatisfiable > 0);
+        printAnswer(_OPTIMUM_);
+        return _OPTIMUM_;
+      }
+
+      for (int i = 0; i < maxsat_formula->nSoft(); i++)
+        if (maxsat_formula->getSoftClause(i).weight >= currentWeight && !activeSoft[i])
+          assumptions.push(~maxsat_formula->getSoftClause(i).assumption_var);
+    }
+
+    if (res == l_False)
+    {
+      nbCores++;
+
+      // Assumes that the first SAT call is done with the soft clauses disabled.
+      if (nbSatisfiable == 0)
+      {
+        printAnswer(_UNSATISFIABLE_);
+        return _UNSATISFIABLE_;
+      }
+
+      if (lbCost == ubCost)
+      {
+        if (verbosity > 0) printf("c LB = UB\n");
+        printAnswer(_OPTIMUM_);
+        return _OPTIMUM_;
+      }
+
+      sumSizeCores += solver->conflict.size();
+
+      // The core may also contain assumptions of the PB encoding, including
+      // relaxed soft clauses that were not encoded yet.
+      joinObjFunction.clear();
+      joinCoeffs.clear();
+      for (int i = 0; i < solver->conflict.size(); i++)
+      {
+        int index_soft = softIndex(solver->conflict[i]);
+        if (index_soft == -1)
+          continue;
+        if (activeSoft[index_soft])
+          continue;
+        activeSoft[index_soft] = true;
+        reachableCosts.add(maxsat_formula->getSoftClause(index_soft).weight);
+        joinObjFunction.push(maxsat_formula->getSoftClause(index_soft).relaxation_vars[0]);
+        joinCoeffs.push(maxsat_formula->getSoftClause(index_soft).weight);
+        objFunction.push(maxsat_formula->getSoftClause(index_soft).relaxation_vars[0]);
+        coeffs.push(maxsat_formula->getSoftClause(index_soft).weight);
+      }
+
+      if (verbosity > 0)
+        printf("c Relaxed soft clauses %d / %d\n", objFunction.size(), maxsat_formula->nSoft());
+
+      lbCost = reachableCosts.next(lbCost + 1);
+
       if (verbosity > 0) printf("c LB : %-12" PRIu64 "\n", lbCost);
-      encoder.encodePB(solver, objFunction, coeffs, lbCost);
+
+      // While the encoding is not built, the previously relaxed soft clauses
+      // are kept by the encoder and only the new ones are given.
+      encodingAssumptions.clear();
+      if (!encoder.hasPBEncoding())
+        encoder.incEncodePB(solver, joinObjFunction, joinCoeffs, lbCost,
+                            encodingAssumptions, maxsat_formula->nSoft());
+      else
+      {
+        encoder.incUpdatePB(solver, joinObjFunction, joinCoeffs, lbCost,
+                            encodingAssumptions);
+        encodingAssumptions.clear();
+        encoder.incUpdatePBAssumptions(solver, encodingAssumptions);
+      }
+
+      assumptions.clear();
+      for (int i = 0; i < maxsat_formula->nSoft(); i++)
+        if (maxsat_formula->getSoftClause(i).weight >= currentWeight && !activeSoft[i])
+          assumptions.push(~maxsat_formula->getSoftClause(i).assumption_var);
+      for (int i = 0; i < encodingAssumptions.size(); i++)
+        assumptions.push(encodingAssumptions[i]);
     }
   }
 
@@ -175,6 +314,9 @@ StatusCode WMSU3::search()
   printConfiguration();
   if (!is_bmo) currentWeight = 1; // No weight strategy none.
 
+  if (incremental_strategy == _INCREMENTAL_ITERATIVE_ &&
+      encoder.getPBEncoding() == _PB_SWC_)
+    return WMSU3_iterative();
   return WMSU3_none();
 }
 
@@ -245,53 +387,10 @@ void WMSU3::initRelaxation()
     Lit l = maxsat_formula->newLiteral();
     maxsat_formula->getSoftClause(i).relaxation_vars.push(l);
     maxsat_formula->getSoftClause(i).assumption_var = l;
+    setCoreMapping(l, i);
   }
 }
 
-// Returns true if there is a subset of set[] with sum equal to given sum
-bool WMSU3::subsetSum(vec<uint64_t> &set, int64_t sum)
-{
-  int n = set.size();
-  
-  // Declaring the array dynamically to avoid stack frame limit
-  bool ** subset = new bool*[sum+1];
-  for (int i = 0; i <= sum; i++)
-    subset[i] = new bool[n+1];
-
-  // The value of subset[i][j] will be true if there is a subset of set[0..j-1]
-  //  with sum equal to i
-  
-  // If sum is 0, then answer is true
-  for (int i = 0; i <= n; i++)
-  {
-    //assert (i < n+1);
-    //printf("i %d\n",i);
-    subset[0][i] = true;
-  }
-
-  // If sum is not 0 and set is empty, then answer is false
-  for (int i = 1; i <= sum; i++)
-    subset[i][0] = false;
-
-  // Fill the subset table in bottom up manner
-  for (int i = 1; i <= sum; i++)
-  {
-    for (int j = 1; j <= n; j++)
-    {
-      subset[i][j] = subset[i][j - 1];
-      if (i >= set[j - 1])
-        subset[i][j] = subset[i][j] || subset[i - set[j - 1]][j - 1];
-    }
-  }
-
-  bool is_subset = subset[sum][n];
-  for (int i = 0; i <= sum; i++)
-    delete [] subset[i];
-  delete [] subset;
-
-  return is_subset;
-}
-
 // Print WSMU3 configuration.
 void WMSU3::print_WMSU3_configuration()
 {
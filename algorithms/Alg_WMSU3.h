@@ -33,6 +33,7 @@
 
 #include "../MaxSAT.h"
 #include "../Encoder.h"
+#include "../SubsetSum.h"
 #include <vector>
 #include <map>
 #include <set>
@@ -90,12 +91,11 @@ protected:
   // Search methods
   //
   StatusCode WMSU3_none();
+  StatusCode WMSU3_iterative();
   
   // Other
   //
   void initRelaxation(); // Relaxes soft clauses.
-  // subsetsum with dynamic programming.
-  bool subsetSum(vec<uint64_t> &set, int64_t num);
   void print_WMSU3_configuration(); // Print WSMU3 configuration.
 
   Solver *solver;  // SAT Solver used as a black box.
@@ -112,9 +112,7 @@ protected:
   vec<Lit> objFunction;
   vec<uint64_t> coeffs; // Coefficients of the literals that are used in the
                    // constraint that excludes models.
-
-  std::map<Lit, int> coreMapping; // Mapping between the assumption literal and
-                                  // the respective soft clause.
+  SubsetSum reachableCosts; // Costs reachable by the coefficients.
 
   // Soft clauses that are currently in the MaxSAT formula.
   vec<bool> activeSoft;
@@ -0,0 +1,255 @@
+/root/repo/AssumptionSet.o /root/repo/AssumptionSet.or /root/repo/AssumptionSet.od /root/repo/AssumptionSet.op: /root/repo/AssumptionSet.cc /root/repo/AssumptionSet.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h
+/root/repo/CardinalityBounds.o /root/repo/CardinalityBounds.or /root/repo/CardinalityBounds.od /root/repo/CardinalityBounds.op: /root/repo/CardinalityBounds.cc \
+ /root/repo/CardinalityBounds.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h
+/root/repo/ConflictBudget.o /root/repo/ConflictBudget.or /root/repo/ConflictBudget.od /root/repo/ConflictBudget.op: /root/repo/ConflictBudget.cc \
+ /root/repo/ConflictBudget.h /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h
+/root/repo/Encoder.o /root/repo/Encoder.or /root/repo/Encoder.od /root/repo/Encoder.op: /root/repo/Encoder.cc /root/repo/Encoder.h \
+ /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h /root/repo/MaxTypes.h \
+ /root/repo/encodings/Enc_CNetworks.h /root/repo/encodings/Encodings.h \
+ /root/repo/encodings/../MaxTypes.h /root/repo/encodings/Enc_GTE.h \
+ /root/repo/encodings/Enc_Ladder.h /root/repo/encodings/Enc_MTotalizer.h \
+ /root/repo/encodings/Enc_SWC.h /root/repo/encodings/Enc_Totalizer.h \
+ /root/repo/encodings/Enc_Adder.h
+/root/repo/LocalSearch.o /root/repo/LocalSearch.or /root/repo/LocalSearch.od /root/repo/LocalSearch.op: /root/repo/LocalSearch.cc /root/repo/LocalSearch.h \
+ /root/repo/MaxSATFormula.h /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h /root/repo/FormulaPB.h \
+ /root/repo/MaxTypes.h /root/repo/solvers/glucose4.1/mtl/Sort.h
+/root/repo/Main.o /root/repo/Main.or /root/repo/Main.od /root/repo/Main.op: /root/repo/Main.cc /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/utils/System.h \
+ /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h /root/repo/MaxSAT.h \
+ /root/repo/ConflictBudget.h /root/repo/LocalSearch.h \
+ /root/repo/MaxSATFormula.h /root/repo/FormulaPB.h /root/repo/MaxTypes.h \
+ /root/repo/ParserMaxSAT.h /root/repo/graph/Stream_Partitioner.h \
+ /root/repo/ParserPB.h /root/repo/ParserPartitions.h \
+ /root/repo/MaxSAT_Partition.h /root/repo/PartitionCores.h \
+ /root/repo/graph/Graph.h /root/repo/graph/Graph_Communities.h \
+ /root/repo/graph/Graph.h /root/repo/graph/Hypergraph.h \
+ /root/repo/graph/Hypergraph.h /root/repo/Portfolio.h \
+ /root/repo/algorithms/Alg_MSU3.h /root/repo/algorithms/../Encoder.h \
+ /root/repo/algorithms/../MaxTypes.h \
+ /root/repo/algorithms/../encodings/Enc_CNetworks.h \
+ /root/repo/algorithms/../encodings/Encodings.h \
+ /root/repo/algorithms/../encodings/../MaxTypes.h \
+ /root/repo/algorithms/../encodings/Enc_GTE.h \
+ /root/repo/algorithms/../encodings/Enc_Ladder.h \
+ /root/repo/algorithms/../encodings/Enc_MTotalizer.h \
+ /root/repo/algorithms/../encodings/Enc_SWC.h \
+ /root/repo/algorithms/../encodings/Enc_Totalizer.h \
+ /root/repo/algorithms/../encodings/Enc_Adder.h \
+ /root/repo/algorithms/../MaxSAT.h /root/repo/algorithms/Alg_OLL.h \
+ /root/repo/algorithms/../CardinalityBounds.h \
+ /root/repo/algorithms/Alg_WBO.h /root/repo/algorithms/../MaxTypes.h \
+ /root/repo/algorithms/Alg_UpOLL.h \
+ /root/repo/algorithms/../AssumptionSet.h \
+ /root/repo/algorithms/../PartitionSchedule.h \
+ /root/repo/algorithms/../MaxSATFormula.h \
+ /root/repo/algorithms/../graph/Graph.h \
+ /root/repo/algorithms/../MaxSAT_Partition.h \
+ /root/repo/algorithms/Alg_UpMSU3.h \
+ /root/repo/algorithms/../graph/TreeNode.h \
+ /root/repo/algorithms/../graph/../Encoder.h \
+ /root/repo/algorithms/Alg_UpWBO.h /root/repo/algorithms/Alg_WMSU3.h \
+ /root/repo/algorithms/../SubsetSum.h /root/repo/algorithms/Alg_UpWMSU3.h \
+ /root/repo/algorithms/Alg_UpLNS.h
+/root/repo/MaxSAT.o /root/repo/MaxSAT.or /root/repo/MaxSAT.od /root/repo/MaxSAT.op: /root/repo/MaxSAT.cc /root/repo/MaxSAT.h \
+ /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h \
+ /root/repo/ConflictBudget.h /root/repo/LocalSearch.h \
+ /root/repo/MaxSATFormula.h /root/repo/FormulaPB.h /root/repo/MaxTypes.h \
+ /root/repo/solvers/glucose4.1/utils/System.h /root/repo/Portfolio.h
+/root/repo/MaxSATFormula.o /root/repo/MaxSATFormula.or /root/repo/MaxSATFormula.od /root/repo/MaxSATFormula.op: /root/repo/MaxSATFormula.cc /root/repo/MaxSATFormula.h \
+ /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h /root/repo/FormulaPB.h \
+ /root/repo/MaxTypes.h
+/root/repo/MaxSAT_Partition.o /root/repo/MaxSAT_Partition.or /root/repo/MaxSAT_Partition.od /root/repo/MaxSAT_Partition.op: /root/repo/MaxSAT_Partition.cc \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h /root/repo/MaxSAT_Partition.h \
+ /root/repo/MaxSAT.h /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h \
+ /root/repo/ConflictBudget.h /root/repo/LocalSearch.h \
+ /root/repo/MaxSATFormula.h /root/repo/FormulaPB.h /root/repo/MaxTypes.h \
+ /root/repo/solvers/glucose4.1/utils/System.h /root/repo/PartitionCores.h \
+ /root/repo/graph/Graph.h /root/repo/graph/Graph_Communities.h \
+ /root/repo/graph/Graph.h /root/repo/graph/Hypergraph.h \
+ /root/repo/graph/Hypergraph.h
+/root/repo/ParserPB.o /root/repo/ParserPB.or /root/repo/ParserPB.od /root/repo/ParserPB.op: /root/repo/ParserPB.cc /root/repo/ParserPB.h \
+ /root/repo/MaxSATFormula.h /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h /root/repo/FormulaPB.h \
+ /root/repo/MaxTypes.h
+/root/repo/PartitionCores.o /root/repo/PartitionCores.or /root/repo/PartitionCores.od /root/repo/PartitionCores.op: /root/repo/PartitionCores.cc \
+ /root/repo/PartitionCores.h /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h \
+ /root/repo/MaxSATFormula.h /root/repo/FormulaPB.h /root/repo/MaxTypes.h
+/root/repo/PartitionSchedule.o /root/repo/PartitionSchedule.or /root/repo/PartitionSchedule.od /root/repo/PartitionSchedule.op: /root/repo/PartitionSchedule.cc \
+ /root/repo/PartitionSchedule.h /root/repo/MaxSATFormula.h \
+ /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h /root/repo/FormulaPB.h \
+ /root/repo/MaxTypes.h /root/repo/graph/Graph.h \
+ /root/repo/solvers/glucose4.1/mtl/Sort.h
+/root/repo/Portfolio.o /root/repo/Portfolio.or /root/repo/Portfolio.od /root/repo/Portfolio.op: /root/repo/Portfolio.cc /root/repo/Portfolio.h \
+ /root/repo/MaxSAT.h /root/repo/solvers/glucose4.1/core/Solver.h \
+ /root/repo/solvers/glucose4.1/mtl/Heap.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h \
+ /root/repo/solvers/glucose4.1/mtl/Alg.h \
+ /root/repo/solvers/glucose4.1/utils/Options.h \
+ /root/repo/solvers/glucose4.1/utils/ParseUtils.h \
+ /root/repo/solvers/glucose4.1/core/SolverTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/Map.h \
+ /root/repo/solvers/glucose4.1/mtl/Alloc.h \
+ /root/repo/solvers/glucose4.1/core/BoundedQueue.h \
+ /root/repo/solvers/glucose4.1/core/Constants.h \
+ /root/repo/solvers/glucose4.1/mtl/Clone.h \
+ /root/repo/solvers/glucose4.1/core/SolverStats.h \
+ /root/repo/ConflictBudget.h /root/repo/LocalSearch.h \
+ /root/repo/MaxSATFormula.h /root/repo/FormulaPB.h /root/repo/MaxTypes.h \
+ /root/repo/solvers/glucose4.1/utils/System.h
+/root/repo/SubsetSum.o /root/repo/SubsetSum.or /root/repo/SubsetSum.od /root/repo/SubsetSum.op: /root/repo/SubsetSum.cc /root/repo/SubsetSum.h \
+ /root/repo/solvers/glucose4.1/mtl/Vec.h \
+ /root/repo/solvers/glucose4.1/mtl/IntTypes.h \
+ /root/repo/solvers/glucose4.1/mtl/XAlloc.h
@@ -31,6 +31,8 @@
 
 #include "Graph.h"
 #include "Graph_Communities.h"
+#include "Graph_Partitioner.h"
+#include "Hypergraph_Communities.h"
 
 #include "mtl/Vec.h"
 
@@ -44,6 +46,7 @@ Graph_Communities::Graph_Communities() {
   _nCommunities = 0;
   _modularity = 0.0;
   _g = NULL;
+  _seed = 0;
 }
 
 Graph_Communities::~Graph_Communities() {}
@@ -95,6 +98,51 @@ int Graph_Communities::findCommunities(int mode, Graph *g) {
   return _nCommunities;
 }
 
+int Graph_Communities::findBalancedCommunities(Graph *g,
+                                               vec<double> &vertexWeights,
+                                               int k, double imbalance) {
+  Graph_Partitioner gp;
+  gp.setRandomSeed(rand_r(&_seed));
+  gp.partition(g, vertexWeights, k, imbalance);
+
+  _g = g;
+  resetInternalData();
+  for (int i = 0; i < g->nVertexes(); i++)
+    _vertexToComm[i] = gp.vertexPartition(i);
+
+  // Collapsed graph is kept to provide the adjacent communities
+  _g = nextIterationGraph();
+
+  _vertexCommunity.clear();
+  _vertexCommunity.growTo(g->nVertexes());
+  for (int i = 0; i < g->nVertexes(); i++)
+    _vertexCommunity[i] = _renumber[_vertexToComm[i]];
+
+  resetInternalData();
+  _modularity = modularity();
+
+  return _nCommunities;
+}
+
+int Graph_Communities::findHypergraphCommunities(Hypergraph *h) {
+  Hypergraph_Communities hc;
+  hc.setRandomSeed(rand_r(&_seed));
+  hc.findCommunities(h);
+
+  _nCommunities = hc.nCommunities();
+  _modularity = hc.getModularity();
+
+  _vertexCommunity.clear();
+  _vertexCommunity.growTo(h->nVertexes());
+  for (int i = 0; i < h->nVertexes(); i++)
+    _vertexCommunity[i] = hc.vertexCommunity(i);
+
+  // Collapsed graph is kept to provide the adjacent communities
+  _g = hc.communityGraph();
+
+  return _nCommunities;
+}
+
 /// Internal
 
 bool Graph_Communities::iterate() {
@@ -108,7 +156,7 @@ bool Graph_Communities::iterate() {
     random_order[i] = i;
 
   for (int i = 0; i < _g->nVertexes() - 1; i++) {
-    int rand_pos = rand() % (_g->nVertexes() - i) + i;
+    int rand_pos = rand_r(&_seed) % (_g->nVertexes() - i) + i;
     int tmp = random_order[i];
     random_order[i] = random_order[rand_pos];
     random_order[rand_pos] = tmp;
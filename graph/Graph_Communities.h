@@ -30,6 +30,7 @@
 #define __GRAPH_COMMUNITIES__
 
 #include "Graph.h"
+#include "Hypergraph.h"
 #include <string.h>
 
 #include "mtl/Vec.h"
@@ -38,7 +39,14 @@ using namespace std;
 
 namespace upmax {
 
-enum splitMode_ { RAND_MODE, UNFOLDING_MODE, LABEL_PROP_MODE, PWCNF_MODE};
+enum splitMode_ {
+  RAND_MODE,
+  UNFOLDING_MODE,
+  LABEL_PROP_MODE,
+  PWCNF_MODE,
+  MULTILEVEL_MODE,
+  STREAM_MODE
+};
 
 class Graph_Communities {
 public:
@@ -49,11 +57,24 @@ public:
 
   int findCommunities(int mode, Graph *g);
 
+  // Balanced k-way partitioning where the vertex weights of each community
+  // are at most (1 + imbalance) times the average.
+  int findBalancedCommunities(Graph *g, vec<double> &vertexWeights, int k,
+                              double imbalance);
+
+  // Unfolding method on the hypergraph, without building its clique
+  // expansion.
+  int findHypergraphCommunities(Hypergraph *h);
+
   // Valid after findCommunities is called.
   inline int nCommunities() { return _nCommunities; }
   inline int vertexCommunity(int u) { return _vertexCommunity[u]; }
   inline double getModularity() { return _modularity; }
 
+  // Seed of the random vertex orders (see 'rand_r'). The same seed gives
+  // the same communities, independently of other threads.
+  inline void setRandomSeed(unsigned int seed) { _seed = seed; }
+
   inline const vec<int> &adjCommunities(int c) { return _g->vertexEdges(c); }
   inline const vec<double> &adjCommunityWeights(int c) {
     return _g->vertexWeights(c);
@@ -95,6 +116,8 @@ protected:
 
   vec<int> _renumber;
 
+  unsigned int _seed; // State of the random generator
+
   // Label propagation method
 };
 
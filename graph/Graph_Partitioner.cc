@@ -0,0 +1,443 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#include <stdlib.h>
+
+#include "Graph.h"
+#include "Graph_Partitioner.h"
+#include "NodeHeap.h"
+
+#include "mtl/Vec.h"
+
+using namespace upmax;
+
+#define PRECISION 0.000001
+
+#define COARSEST_SIZE 64   // Coarsening stops below this number of vertexes
+#define COARSEN_RATIO 0.95 // Coarsening stops if matching no longer shrinks
+#define INITIAL_TRIES 4    // Number of greedy graph growing attempts
+#define FM_PASSES 8        // Maximum number of refinement passes per level
+#define FM_STALL 64        // Moves without improvement before ending a pass
+
+Graph_Partitioner::Graph_Partitioner() {
+  _nPartitions = 0;
+  _imbalance = 0.0;
+  _maxWeight[0] = _maxWeight[1] = 0.0;
+  _seed = 0;
+}
+
+Graph_Partitioner::~Graph_Partitioner() {}
+
+int Graph_Partitioner::partition(Graph *g, vec<double> &vertexWeights, int k,
+                                 double imbalance) {
+  assert(vertexWeights.size() == g->nVertexes());
+
+  if (k > g->nVertexes())
+    k = g->nVertexes();
+  if (k < 1)
+    k = 1;
+  _nPartitions = k;
+
+  _vertexPartition.clear();
+  _vertexPartition.growTo(g->nVertexes(), 0);
+
+  // The allowed imbalance is split among the levels of the bisection tree
+  int levels = 0;
+  for (int i = 1; i < k; i *= 2)
+    levels++;
+  _imbalance = (levels > 0 ? imbalance / levels : imbalance);
+
+  // If no vertex has weight then the number of vertexes is balanced instead
+  vec<double> vw;
+  vertexWeights.copyTo(vw);
+  double total = 0.0;
+  for (int i = 0; i < vw.size(); i++)
+    total += vw[i];
+  if (total <= 0.0)
+    for (int i = 0; i < vw.size(); i++)
+      vw[i] = 1.0;
+
+  vec<int> vertexes;
+  for (int i = 0; i < g->nVertexes(); i++)
+    vertexes.push(i);
+
+  recursiveBisection(g, vw, vertexes, k, 0);
+
+  return _nPartitions;
+}
+
+/// Internal
+
+// vertexes maps the vertexes of g to the vertexes of the original graph.
+void Graph_Partitioner::recursiveBisection(Graph *g, vec<double> &vw,
+                                           vec<int> &vertexes, int k,
+                                           int first) {
+  if (k == 1 || g->nVertexes() <= 1) {
+    for (int i = 0; i < vertexes.size(); i++)
+      _vertexPartition[vertexes[i]] = first;
+    return;
+  }
+
+  int k0 = k / 2;
+  double total = 0.0;
+  for (int i = 0; i < vw.size(); i++)
+    total += vw[i];
+
+  double target = total * k0 / k;
+  _maxWeight[0] = target * (1 + _imbalance);
+  _maxWeight[1] = (total - target) * (1 + _imbalance);
+
+  vec<int> side;
+  bisect(g, vw, target, side);
+
+  for (int s = 0; s < 2; s++) {
+    vec<int> local;
+    Graph *sg = inducedGraph(g, side, s, local);
+
+    vec<int> sv;
+    vec<double> sw;
+    for (int i = 0; i < local.size(); i++) {
+      sv.push(vertexes[local[i]]);
+      sw.push(vw[local[i]]);
+    }
+
+    recursiveBisection(sg, sw, sv, (s == 0 ? k0 : k - k0),
+                       (s == 0 ? first : first + k0));
+    delete sg;
+  }
+}
+
+// Multilevel bisection: side 0 is expected to have weight close to target.
+void Graph_Partitioner::bisect(Graph *g, vec<double> &vw, double target,
+                               vec<int> &side) {
+  if (g->nVertexes() > COARSEST_SIZE) {
+    vec<int> cmap;
+    vec<double> cvw;
+    Graph *cg = coarsen(g, vw, cmap, cvw);
+
+    if (cg != NULL) {
+      vec<int> cside;
+      bisect(cg, cvw, target, cside);
+      delete cg;
+
+      // Project the bisection to the finer graph and refine it
+      side.clear();
+      side.growTo(g->nVertexes());
+      for (int u = 0; u < g->nVertexes(); u++)
+        side[u] = cside[cmap[u]];
+
+      refineFM(g, vw, side);
+      return;
+    }
+  }
+
+  initialBisection(g, vw, target, side);
+}
+
+// Heavy-edge matching. Returns NULL if the graph does not shrink enough.
+Graph *Graph_Partitioner::coarsen(Graph *g, vec<double> &vw, vec<int> &cmap,
+                                  vec<double> &cvw) {
+  int n = g->nVertexes();
+
+  // Avoid coarse vertexes too heavy to be balanced
+  double total = 0.0;
+  for (int i = 0; i < n; i++)
+    total += vw[i];
+  double maxWeight = 1.5 * total / COARSEST_SIZE;
+
+  // Generates a random order of vertexes
+  vec<int> order;
+  for (int i = 0; i < n; i++)
+    order.push(i);
+  for (int i = 0; i < n - 1; i++) {
+    int rand_pos = rand_r(&_seed) % (n - i) + i;
+    int tmp = order[i];
+    order[i] = order[rand_pos];
+    order[rand_pos] = tmp;
+  }
+
+  cmap.clear();
+  cmap.growTo(n, -1);
+  int nc = 0;
+
+  for (int i = 0; i < n; i++) {
+    int u = order[i];
+    if (cmap[u] != -1)
+      continue;
+
+    vec<int> &edges = g->vertexEdges(u);
+    vec<double> &weights = g->vertexWeights(u);
+
+    int match = u;
+    double best = 0.0;
+    for (int j = 0; j < edges.size(); j++) {
+      int v = edges[j];
+      if (v == u || cmap[v] != -1 || vw[u] + vw[v] > maxWeight)
+        continue;
+      if (weights[j] > best) {
+        best = weights[j];
+        match = v;
+      }
+    }
+
+    cmap[u] = nc;
+    cmap[match] = nc;
+    nc++;
+  }
+
+  if (nc > COARSEN_RATIO * n)
+    return NULL;
+
+  cvw.clear();
+  cvw.growTo(nc, 0.0);
+  for (int u = 0; u < n; u++)
+    cvw[cmap[u]] += vw[u];
+
+  // Edges inside a coarse vertex are never cut and can be dropped
+  Graph *cg = new Graph(nc);
+  for (int u = 0; u < n; u++) {
+    vec<int> &edges = g->vertexEdges(u);
+    vec<double> &weights = g->vertexWeights(u);
+    for (int j = 0; j < edges.size(); j++)
+      if (cmap[u] != cmap[edges[j]])
+        cg->addEdge(cmap[u], cmap[edges[j]], weights[j]);
+  }
+  cg->mergeDuplicatedEdges();
+
+  return cg;
+}
+
+// Greedy graph growing from random seeds, keeping the best refined cut.
+void Graph_Partitioner::initialBisection(Graph *g, vec<double> &vw,
+                                         double target, vec<int> &side) {
+  int n = g->nVertexes();
+  vec<int> best;
+  double bestCut = 0.0;
+  bool bestBalanced = false;
+
+  for (int t = 0; t < INITIAL_TRIES; t++) {
+    // Seeds are picked in random order whenever the region stops growing
+    vec<int> order;
+    for (int i = 0; i < n; i++)
+      order.push(i);
+    for (int i = 0; i < n - 1; i++) {
+      int rand_pos = rand_r(&_seed) % (n - i) + i;
+      int tmp = order[i];
+      order[i] = order[rand_pos];
+      order[rand_pos] = tmp;
+    }
+
+    side.clear();
+    side.growTo(n, 1);
+
+    NodeHeap<double> heap(n, 0.0, false);
+    double w0 = 0.0;
+    int next = 0;
+
+    while (w0 < target) {
+      int u = heap.pop();
+      if (u == -1) {
+        while (next < n && side[order[next]] == 0)
+          next++;
+        if (next == n)
+          break;
+        u = order[next];
+      }
+
+      side[u] = 0;
+      w0 += vw[u];
+
+      vec<int> &edges = g->vertexEdges(u);
+      vec<double> &weights = g->vertexWeights(u);
+      for (int j = 0; j < edges.size(); j++) {
+        int v = edges[j];
+        if (side[v] == 1)
+          heap.changeValue(v, heap.value(v) + weights[j]);
+      }
+    }
+
+    refineFM(g, vw, side);
+
+    double w[2] = {0.0, 0.0};
+    for (int u = 0; u < n; u++)
+      w[side[u]] += vw[u];
+    bool balanced = w[0] <= _maxWeight[0] + PRECISION &&
+                    w[1] <= _maxWeight[1] + PRECISION;
+    double cut = cutWeight(g, side);
+
+    if (t == 0 || (balanced && !bestBalanced) ||
+        (balanced == bestBalanced && cut < bestCut)) {
+      side.copyTo(best);
+      bestCut = cut;
+      bestBalanced = balanced;
+    }
+  }
+
+  best.copyTo(side);
+}
+
+// Fiduccia-Mattheyses refinement of a bisection. Each pass moves vertexes
+// with the highest gain and keeps the best prefix of moves, preferring
+// balanced bisections over smaller cuts.
+void Graph_Partitioner::refineFM(Graph *g, vec<double> &vw, vec<int> &side) {
+  int n = g->nVertexes();
+
+  double w[2] = {0.0, 0.0};
+  for (int u = 0; u < n; u++)
+    w[side[u]] += vw[u];
+
+  vec<double> gain;
+  vec<bool> locked;
+  vec<int> moves;
+  gain.growTo(n);
+  locked.growTo(n);
+
+  for (int pass = 0; pass < FM_PASSES; pass++) {
+    double excess = (w[0] > _maxWeight[0] ? w[0] - _maxWeight[0] : 0.0) +
+                    (w[1] > _maxWeight[1] ? w[1] - _maxWeight[1] : 0.0);
+    bool balanced = excess <= PRECISION;
+
+    // Only boundary vertexes are considered unless the bisection is not
+    // balanced
+    NodeHeap<double> heap(n, 0.0, false);
+    for (int u = 0; u < n; u++) {
+      vec<int> &edges = g->vertexEdges(u);
+      vec<double> &weights = g->vertexWeights(u);
+      bool boundary = false;
+
+      gain[u] = 0.0;
+      locked[u] = false;
+      for (int j = 0; j < edges.size(); j++) {
+        if (edges[j] == u)
+          continue;
+        if (side[edges[j]] != side[u]) {
+          gain[u] += weights[j];
+          boundary = true;
+        } else
+          gain[u] -= weights[j];
+      }
+
+      if (boundary || !balanced)
+        heap.changeValue(u, gain[u]);
+    }
+
+    double cumulative = 0.0, bestGain = 0.0, bestExcess = excess;
+    int bestMoves = 0, stall = 0;
+    moves.clear();
+
+    while (heap.size() > 0 && stall < FM_STALL) {
+      int u = heap.pop();
+      int from = side[u], to = 1 - from;
+
+      // A move may not overload the destination, unless it relieves an
+      // overloaded side
+      if (w[to] + vw[u] > _maxWeight[to] + PRECISION &&
+          (w[from] <= _maxWeight[from] || w[to] + vw[u] >= w[from]))
+        continue;
+
+      locked[u] = true;
+      side[u] = to;
+      w[from] -= vw[u];
+      w[to] += vw[u];
+      cumulative += gain[u];
+      moves.push(u);
+
+      vec<int> &edges = g->vertexEdges(u);
+      vec<double> &weights = g->vertexWeights(u);
+      for (int j = 0; j < edges.size(); j++) {
+        int v = edges[j];
+        if (v == u)
+          continue;
+        gain[v] += (side[v] == to ? -2 * weights[j] : 2 * weights[j]);
+        if (!locked[v])
+          heap.changeValue(v, gain[v]);
+      }
+
+      excess = (w[0] > _maxWeight[0] ? w[0] - _maxWeight[0] : 0.0) +
+               (w[1] > _maxWeight[1] ? w[1] - _maxWeight[1] : 0.0);
+      if (excess < bestExcess - PRECISION ||
+          (excess <= bestExcess + PRECISION &&
+           cumulative > bestGain + PRECISION)) {
+        bestExcess = excess;
+        bestGain = cumulative;
+        bestMoves = moves.size();
+        stall = 0;
+      } else
+        stall++;
+    }
+
+    // Undo the moves after the best prefix
+    for (int i = moves.size() - 1; i >= bestMoves; i--) {
+      int u = moves[i];
+      w[side[u]] -= vw[u];
+      side[u] = 1 - side[u];
+      w[side[u]] += vw[u];
+    }
+
+    if (bestMoves == 0)
+      break;
+  }
+}
+
+// Graph induced by the vertexes on side s. vertexes maps the new vertexes to
+// the vertexes of g.
+Graph *Graph_Partitioner::inducedGraph(Graph *g, vec<int> &side, int s,
+                                       vec<int> &vertexes) {
+  vec<int> local;
+  local.growTo(g->nVertexes(), -1);
+  for (int u = 0; u < g->nVertexes(); u++)
+    if (side[u] == s) {
+      local[u] = vertexes.size();
+      vertexes.push(u);
+    }
+
+  Graph *sg = new Graph(vertexes.size());
+  for (int i = 0; i < vertexes.size(); i++) {
+    vec<int> &edges = g->vertexEdges(vertexes[i]);
+    vec<double> &weights = g->vertexWeights(vertexes[i]);
+    for (int j = 0; j < edges.size(); j++)
+      if (side[edges[j]] == s)
+        sg->addEdge(i, local[edges[j]], weights[j]);
+  }
+
+  return sg;
+}
+
+double Graph_Partitioner::cutWeight(Graph *g, vec<int> &side) {
+  double cut = 0.0;
+  for (int u = 0; u < g->nVertexes(); u++) {
+    vec<int> &edges = g->vertexEdges(u);
+    vec<double> &weights = g->vertexWeights(u);
+    for (int j = 0; j < edges.size(); j++)
+      if (side[edges[j]] != side[u])
+        cut += weights[j];
+  }
+  // Each edge is stored in both directions
+  return cut / 2;
+}
@@ -0,0 +1,93 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#ifndef __GRAPH_PARTITIONER__
+#define __GRAPH_PARTITIONER__
+
+#include "Graph.h"
+
+#include "mtl/Vec.h"
+
+using namespace std;
+
+namespace upmax {
+
+// Multilevel balanced k-way partitioning by recursive bisection.
+// Each bisection coarsens the graph with heavy-edge matching, computes an
+// initial bisection on the coarsest graph by greedy graph growing and
+// projects it back while refining with Fiduccia-Mattheyses.
+class Graph_Partitioner {
+public:
+  // Constructor/Destructor:
+  //
+  Graph_Partitioner();
+  ~Graph_Partitioner();
+
+  // Splits g into at most k partitions such that the vertex weight of each
+  // partition does not exceed (1 + imbalance) times the average weight.
+  int partition(Graph *g, vec<double> &vertexWeights, int k,
+                double imbalance);
+
+  // Valid after partition is called.
+  inline int nPartitions() { return _nPartitions; }
+  inline int vertexPartition(int u) { return _vertexPartition[u]; }
+
+  // Seed of the random vertex orders (see 'rand_r').
+  inline void setRandomSeed(unsigned int seed) { _seed = seed; }
+
+protected:
+  void recursiveBisection(Graph *g, vec<double> &vw, vec<int> &vertexes,
+                          int k, int first);
+
+  void bisect(Graph *g, vec<double> &vw, double target, vec<int> &side);
+
+  // Coarsening
+  Graph *coarsen(Graph *g, vec<double> &vw, vec<int> &cmap,
+                 vec<double> &cvw);
+
+  // Initial bisection and refinement
+  void initialBisection(Graph *g, vec<double> &vw, double target,
+                        vec<int> &side);
+  void refineFM(Graph *g, vec<double> &vw, vec<int> &side);
+
+  Graph *inducedGraph(Graph *g, vec<int> &side, int s, vec<int> &vertexes);
+  double cutWeight(Graph *g, vec<int> &side);
+
+protected:
+  int _nPartitions;
+  vec<int> _vertexPartition;
+
+  double _imbalance;    // imbalance allowed in each bisection
+  double _maxWeight[2]; // maximum weight of each side in current bisection
+  unsigned int _seed;   // state of the random generator
+};
+
+} // namespace upmax
+
+#endif
@@ -0,0 +1,108 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#include <iostream>
+
+#include <stdlib.h>
+
+#include "Hypergraph.h"
+
+using namespace upmax;
+
+Hypergraph::Hypergraph(int nVert) {
+  _nVert = nVert;
+  _totalWeights.growTo(_nVert, 0.0);
+  _nSelfLoops.growTo(_nVert, 0.0);
+  _nExtraLoops.growTo(_nVert, 0.0);
+  _totalWeight = 0.0;
+
+  _edgeStart.push(0);
+}
+
+Hypergraph::~Hypergraph() {}
+
+void Hypergraph::addEdge(vec<int> &pins, double w) {
+  vec<int> multiplicity;
+  multiplicity.growTo(pins.size(), 1);
+  addEdge(pins, multiplicity, w);
+}
+
+void Hypergraph::addEdge(vec<int> &pins, vec<int> &multiplicity, double w) {
+  int size = 0;
+  for (int i = 0; i < multiplicity.size(); i++)
+    size += multiplicity[i];
+  if (size < 2)
+    return;
+
+  for (int i = 0; i < pins.size(); i++) {
+    int u = pins[i];
+    double n = multiplicity[i];
+    _totalWeights[u] += w * n * (size - 1);
+    _nSelfLoops[u] += w * n * (n - 1);
+  }
+  _totalWeight += w * size * (size - 1);
+
+  if (pins.size() == 1) {
+    // Hyperedge inside a single vertex is not stored
+    _nExtraLoops[pins[0]] += w * size * (size - 1);
+    return;
+  }
+
+  for (int i = 0; i < pins.size(); i++) {
+    _pins.push(pins[i]);
+    _multiplicity.push(multiplicity[i]);
+  }
+  _edgeStart.push(_pins.size());
+  _edgeWeights.push(w);
+}
+
+void Hypergraph::addSelfLoop(int u, double w) {
+  _totalWeights[u] += w;
+  _nSelfLoops[u] += w;
+  _nExtraLoops[u] += w;
+  _totalWeight += w;
+}
+
+void Hypergraph::buildIncidence() {
+  _incidenceStart.clear();
+  _incidenceStart.growTo(_nVert + 1, 0);
+  _incidence.clear();
+  _incidence.growTo(_pins.size());
+
+  for (int i = 0; i < _pins.size(); i++)
+    _incidenceStart[_pins[i] + 1]++;
+  for (int u = 0; u < _nVert; u++)
+    _incidenceStart[u + 1] += _incidenceStart[u];
+
+  vec<int> next;
+  _incidenceStart.copyTo(next);
+  for (int e = 0; e < nEdges(); e++)
+    for (int i = _edgeStart[e]; i < _edgeStart[e + 1]; i++)
+      _incidence[next[_pins[i]]++] = e;
+}
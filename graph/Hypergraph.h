@@ -0,0 +1,112 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#ifndef __HYPERGRAPH__
+#define __HYPERGRAPH__
+
+#include <stdint.h>
+#include <string.h>
+
+#include "mtl/Vec.h"
+
+using namespace std;
+using NSPACE::vec;
+
+namespace upmax {
+
+// Weighted hypergraph stored as pin lists. Memory is linear in the number of
+// pins, instead of quadratic in the size of each hyperedge as in a clique
+// expansion.
+//
+// Each pin has a multiplicity (number of original vertexes it stands for
+// after contraction) and each pair of original vertexes in a hyperedge is
+// connected with the hyperedge weight. Weighted degrees and self loops follow
+// the corresponding clique expansion, such that modularity can be computed
+// as in a graph.
+class Hypergraph {
+public:
+  // Constructor/Destructor:
+  //
+  Hypergraph(int nVert);
+  ~Hypergraph();
+
+  // pins must be distinct vertexes
+  void addEdge(vec<int> &pins, double w = 1.0);
+  void addEdge(vec<int> &pins, vec<int> &multiplicity, double w);
+  void addSelfLoop(int u, double w);
+
+  // Must be called after all hyperedges are added
+  void buildIncidence();
+
+  // Stats
+  inline int nVertexes() { return _nVert; }
+  inline int nEdges() { return _edgeWeights.size(); }
+  inline int nPins() { return _pins.size(); }
+
+  inline int edgeSize(int e) { return _edgeStart[e + 1] - _edgeStart[e]; }
+  inline int edgePin(int e, int i) { return _pins[_edgeStart[e] + i]; }
+  inline int pinMultiplicity(int e, int i) {
+    return _multiplicity[_edgeStart[e] + i];
+  }
+  inline double edgeWeight(int e) { return _edgeWeights[e]; }
+
+  inline int nIncidentEdges(int u) {
+    return _incidenceStart[u + 1] - _incidenceStart[u];
+  }
+  inline int incidentEdge(int u, int i) {
+    return _incidence[_incidenceStart[u] + i];
+  }
+
+  inline double weightedDegree(int u) { return _totalWeights[u]; }
+  inline double nSelfLoops(int u) { return _nSelfLoops[u]; }
+  inline double nExtraLoops(int u) { return _nExtraLoops[u]; }
+  inline double totalWeight() { return _totalWeight; }
+
+protected:
+  int _nVert;
+
+  // Pin lists of hyperedges
+  vec<int> _edgeStart;
+  vec<int> _pins;
+  vec<int> _multiplicity;
+  vec<double> _edgeWeights;
+
+  // Hyperedges incident to each vertex
+  vec<int> _incidenceStart;
+  vec<int> _incidence;
+
+  vec<double> _totalWeights;
+  double _totalWeight;
+  vec<double> _nSelfLoops;
+  vec<double> _nExtraLoops; // Self loops not represented by stored hyperedges
+};
+
+} // namespace upmax
+
+#endif
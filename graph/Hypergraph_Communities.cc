@@ -0,0 +1,335 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#include <iostream>
+#include <stdlib.h>
+
+#include "Graph.h"
+#include "Hypergraph.h"
+#include "Hypergraph_Communities.h"
+
+#include "mtl/Vec.h"
+
+using namespace upmax;
+
+#define PRECISION 0.000001
+
+Hypergraph_Communities::Hypergraph_Communities() {
+  _nCommunities = 0;
+  _modularity = 0.0;
+  _h = NULL;
+  _seed = 0;
+}
+
+Hypergraph_Communities::~Hypergraph_Communities() {
+  // After findCommunities, the working hypergraph is never the original one
+  if (_h != NULL)
+    delete _h;
+}
+
+int Hypergraph_Communities::findCommunities(Hypergraph *h) {
+  // Clear data from previous run
+  if (_h != NULL)
+    delete _h;
+  _h = h;
+  _vertexCommunity.clear();
+  _vertexCommunity.growTo(_h->nVertexes());
+  for (int i = 0; i < h->nVertexes(); i++)
+    _vertexCommunity[i] = i;
+
+  resetInternalData();
+
+  bool improvement = true;
+  int level = 0;
+  Hypergraph *h_old = NULL;
+
+  do {
+    improvement = iterate();
+    _modularity = modularity();
+
+    ++level;
+
+    h_old = _h;                     // Save ptr to current hypergraph
+    _h = nextIterationHypergraph(); // Generate next iteration hypergraph
+
+    // Update community of original vertexes
+    for (int i = 0; i < h->nVertexes(); i++)
+      _vertexCommunity[i] = _renumber[_vertexToComm[_vertexCommunity[i]]];
+
+    if (level > 1)
+      delete h_old; // Never delete the original hypergraph
+    h_old = NULL;
+
+    resetInternalData();
+
+    if (level == 1) // do at least one more computation
+      improvement = true;
+  } while (improvement);
+
+  return _nCommunities;
+}
+
+// Must be called after findCommunities. The current hypergraph has one vertex
+// for each community.
+Graph *Hypergraph_Communities::communityGraph() {
+  int n = _h->nVertexes();
+  Graph *g = new Graph(n);
+
+  vec<double> w;
+  vec<int> adj;
+  w.growTo(n, 0.0);
+
+  for (int u = 0; u < n; u++) {
+    if (_h->nSelfLoops(u) > 0)
+      g->addEdge(u, u, _h->nSelfLoops(u));
+
+    for (int i = 0; i < _h->nIncidentEdges(u); i++) {
+      int e = _h->incidentEdge(u, i);
+      int nu = 0;
+      for (int j = 0; j < _h->edgeSize(e); j++)
+        if (_h->edgePin(e, j) == u)
+          nu = _h->pinMultiplicity(e, j);
+
+      for (int j = 0; j < _h->edgeSize(e); j++) {
+        int v = _h->edgePin(e, j);
+        if (v == u)
+          continue;
+        if (w[v] == 0)
+          adj.push(v);
+        w[v] += _h->edgeWeight(e) * nu * _h->pinMultiplicity(e, j);
+      }
+    }
+
+    for (int i = 0; i < adj.size(); i++) {
+      g->addEdge(u, adj[i], w[adj[i]]);
+      w[adj[i]] = 0;
+    }
+    adj.clear();
+  }
+
+  return g;
+}
+
+/// Internal
+
+bool Hypergraph_Communities::iterate() {
+  double new_mod = modularity();
+  double cur_mod = new_mod;
+  bool better = false;
+
+  // Generates a random order of vertexes
+  vec<int> random_order;
+  for (int i = 0; i < _h->nVertexes(); i++)
+    random_order.push(i);
+
+  for (int i = 0; i < _h->nVertexes() - 1; i++) {
+    int rand_pos = rand_r(&_seed) % (_h->nVertexes() - i) + i;
+    int tmp = random_order[i];
+    random_order[i] = random_order[rand_pos];
+    random_order[rand_pos] = tmp;
+  }
+
+  // Cycle to improve modularity
+  do {
+    cur_mod = new_mod;
+
+    for (int i = 0; i < _h->nVertexes(); i++) {
+      int vertex = random_order[i];
+      int comm = _vertexToComm[vertex];
+      double factor = _h->weightedDegree(vertex) / _h->totalWeight();
+
+      // computation of all neighboring communities with edges to vertex
+      computeAdjCommunities(vertex);
+
+      // remove vertex from its community
+      remove(vertex, comm, _adjWeight[comm]);
+
+      // determine the best adjacent community to move the vertex to
+      int best_comm = comm;
+      double best_variation = 0.0;
+      for (int j = 0; j < _adjComm.size(); j++) {
+        double variation =
+            _adjWeight[_adjComm[j]] - (_total[_adjComm[j]] * factor);
+        if (variation > best_variation) {
+          best_comm = _adjComm[j];
+          best_variation = variation;
+        }
+      }
+
+      // insert vertex in the best adjacent community
+      insert(vertex, best_comm, _adjWeight[best_comm]);
+
+      if (best_comm != comm)
+        better = true;
+    }
+
+    new_mod = modularity();
+
+  } while (new_mod - cur_mod > PRECISION);
+
+  return better;
+}
+
+// Weight between a vertex and a community is the weight of the clique
+// expansion edges, computed directly from the pins of incident hyperedges.
+void Hypergraph_Communities::computeAdjCommunities(int vertex) {
+  // Reset internal vectors
+  for (int i = 0; i < _adjComm.size(); i++) {
+    _adjWeight[_adjComm[i]] = 0.0;
+    _adjMarked[_adjComm[i]] = false;
+  }
+  _adjComm.clear();
+
+  // Consider current community
+  _adjComm.push(_vertexToComm[vertex]);
+  _adjMarked[_vertexToComm[vertex]] = true;
+
+  for (int i = 0; i < _h->nIncidentEdges(vertex); i++) {
+    int e = _h->incidentEdge(vertex, i);
+    int nu = 0;
+    for (int j = 0; j < _h->edgeSize(e); j++)
+      if (_h->edgePin(e, j) == vertex)
+        nu = _h->pinMultiplicity(e, j);
+
+    for (int j = 0; j < _h->edgeSize(e); j++) {
+      int u = _h->edgePin(e, j);
+      if (u == vertex)
+        continue;
+
+      int comm = _vertexToComm[u];
+      if (!_adjMarked[comm]) {
+        _adjMarked[comm] = true;
+        _adjComm.push(comm);
+      }
+      _adjWeight[comm] += _h->edgeWeight(e) * nu * _h->pinMultiplicity(e, j);
+    }
+  }
+}
+
+Hypergraph *Hypergraph_Communities::nextIterationHypergraph() {
+  // Compute the new number of communities
+  for (int i = 0; i < _h->nVertexes(); i++)
+    _renumber[i] = 0;
+  for (int i = 0; i < _h->nVertexes(); i++)
+    _renumber[_vertexToComm[i]]++;
+
+  _nCommunities = 0;
+  for (int i = 0; i < _h->nVertexes(); i++)
+    if (_renumber[i] != 0)
+      _renumber[i] = _nCommunities++;
+
+  // Compute new hypergraph with collapsed communities
+  Hypergraph *h2 = new Hypergraph(_nCommunities);
+
+  for (int i = 0; i < _h->nVertexes(); i++)
+    if (_h->nExtraLoops(i) > 0)
+      h2->addSelfLoop(_renumber[_vertexToComm[i]], _h->nExtraLoops(i));
+
+  vec<int> pos;
+  vec<int> pins;
+  vec<int> multiplicity;
+  pos.growTo(_nCommunities, -1);
+
+  for (int e = 0; e < _h->nEdges(); e++) {
+    for (int j = 0; j < _h->edgeSize(e); j++) {
+      int comm = _renumber[_vertexToComm[_h->edgePin(e, j)]];
+      if (pos[comm] == -1) {
+        pos[comm] = pins.size();
+        pins.push(comm);
+        multiplicity.push(0);
+      }
+      multiplicity[pos[comm]] += _h->pinMultiplicity(e, j);
+    }
+
+    h2->addEdge(pins, multiplicity, _h->edgeWeight(e));
+
+    for (int j = 0; j < pins.size(); j++)
+      pos[pins[j]] = -1;
+    pins.clear();
+    multiplicity.clear();
+  }
+
+  h2->buildIncidence();
+
+  return h2;
+}
+
+void Hypergraph_Communities::resetInternalData() {
+  _vertexToComm.clear();
+  _inside.clear();
+  _total.clear();
+  _renumber.clear();
+  _adjComm.clear();
+  _adjWeight.clear();
+  _adjMarked.clear();
+
+  _vertexToComm.growTo(_h->nVertexes());
+  _inside.growTo(_h->nVertexes());
+  _total.growTo(_h->nVertexes());
+  _renumber.growTo(_h->nVertexes());
+  _adjWeight.growTo(_h->nVertexes());
+  _adjMarked.growTo(_h->nVertexes());
+
+  for (int i = 0; i < _h->nVertexes(); i++) {
+    _vertexToComm[i] = i;
+    _inside[i] = _h->nSelfLoops(i);
+    _total[i] = _h->weightedDegree(i);
+    _renumber[i] = -1;
+    _adjWeight[i] = 0;
+    _adjMarked[i] = false;
+  }
+}
+
+double Hypergraph_Communities::modularity() {
+  double mod = 0.;
+  double tw2 = _h->totalWeight() * _h->totalWeight();
+
+  for (int i = 0; i < _h->nVertexes(); i++) {
+    if (_total[i] > 0) {
+      mod += _inside[i] / _h->totalWeight() - (_total[i] * _total[i]) / tw2;
+    }
+  }
+  return mod;
+}
+
+void Hypergraph_Communities::remove(int node, int comm, double dnodecomm) {
+  assert(node >= 0 && node < _h->nVertexes());
+
+  _total[comm] -= _h->weightedDegree(node);
+  _inside[comm] -= 2 * dnodecomm + _h->nSelfLoops(node);
+  _vertexToComm[node] = -1;
+}
+
+void Hypergraph_Communities::insert(int node, int comm, double dnodecomm) {
+  assert(node >= 0 && node < _h->nVertexes());
+
+  _total[comm] += _h->weightedDegree(node);
+  _inside[comm] += 2 * dnodecomm + _h->nSelfLoops(node);
+  _vertexToComm[node] = comm;
+}
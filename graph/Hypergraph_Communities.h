@@ -0,0 +1,99 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#ifndef __HYPERGRAPH_COMMUNITIES__
+#define __HYPERGRAPH_COMMUNITIES__
+
+#include "Graph.h"
+#include "Hypergraph.h"
+
+#include "mtl/Vec.h"
+
+using namespace std;
+
+namespace upmax {
+
+// Unfolding method on a hypergraph. Weights between vertexes and communities
+// are computed from the pin lists, hence the clique expansion of the
+// hypergraph is never built.
+class Hypergraph_Communities {
+public:
+  // Constructor/Destructor:
+  //
+  Hypergraph_Communities();
+  ~Hypergraph_Communities();
+
+  int findCommunities(Hypergraph *h);
+
+  // Valid after findCommunities is called.
+  inline int nCommunities() { return _nCommunities; }
+  inline int vertexCommunity(int u) { return _vertexCommunity[u]; }
+  inline double getModularity() { return _modularity; }
+
+  // Seed of the random vertex orders (see 'rand_r').
+  inline void setRandomSeed(unsigned int seed) { _seed = seed; }
+
+  // Graph with a vertex for each community. Caller must delete it.
+  Graph *communityGraph();
+
+protected:
+  bool iterate();
+  void computeAdjCommunities(int vertex);
+  Hypergraph *nextIterationHypergraph();
+
+  void resetInternalData();
+
+  double modularity();
+
+  void remove(int node, int comm, double dnodecomm);
+  void insert(int node, int comm, double dnodecomm);
+
+protected:
+  int _nCommunities;
+  double _modularity;
+  vec<int> _vertexCommunity;
+
+  Hypergraph *_h; // Current working hypergraph
+
+  vec<int> _vertexToComm;
+  vec<double> _inside;
+  vec<double> _total;
+
+  vec<double> _adjWeight;
+  vec<int> _adjComm;
+  vec<bool> _adjMarked;
+
+  vec<int> _renumber;
+
+  unsigned int _seed; // State of the random generator
+};
+
+} // namespace upmax
+
+#endif
@@ -0,0 +1,113 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#include <math.h>
+
+#include "Stream_Partitioner.h"
+
+using namespace upmax;
+
+Stream_Partitioner::Stream_Partitioner(int k, double gamma, double imbalance) {
+  _k = k;
+  _gamma = gamma;
+  _imbalance = imbalance;
+
+  _expectedClauses = 0;
+  _nClauses = 0;
+  _nLiterals = 0;
+
+  _load.growTo(_k, 0);
+  _affinity.growTo(_k, 0.0);
+}
+
+Stream_Partitioner::~Stream_Partitioner() {}
+
+int Stream_Partitioner::assign(vec<Lit> &clause) {
+  _nClauses++;
+  _nLiterals += clause.size();
+
+  for (int p = 0; p < _k; p++)
+    _affinity[p] = 0.0;
+
+  for (int i = 0; i < clause.size(); i++) {
+    int v = var(clause[i]);
+    if (_occurrences.size() <= v)
+      _occurrences.growTo(v + 1);
+    vec<Occurrence> &occ = _occurrences[v];
+    for (int j = 0; j < occ.size(); j++)
+      _affinity[occ[j].partition] += occ[j].count;
+  }
+
+  // Fennel penalty: alpha * gamma * load^(gamma-1), where alpha is scaled
+  // such that the penalty of a balanced partition is close to the average
+  // clause length.
+  double n = (_expectedClauses > _nClauses ? _expectedClauses : _nClauses);
+  double alpha = sqrt((double)_k) * ((double)_nLiterals / _nClauses) *
+                 pow(n, 1 - _gamma);
+  double capacity = (1 + _imbalance) * n / _k;
+
+  int best = -1;
+  double best_score = 0.0;
+  for (int p = 0; p < _k; p++) {
+    // The capacity is only known if the header gives the number of clauses
+    if (_expectedClauses > 0 && _load[p] + 1 > capacity)
+      continue;
+
+    double score =
+        _affinity[p] - alpha * _gamma * pow((double)_load[p], _gamma - 1);
+    if (best == -1 || score > best_score ||
+        (score == best_score && _load[p] < _load[best])) {
+      best = p;
+      best_score = score;
+    }
+  }
+
+  if (best == -1) {
+    // All partitions are full
+    best = 0;
+    for (int p = 1; p < _k; p++)
+      if (_load[p] < _load[best])
+        best = p;
+  }
+
+  _load[best]++;
+  for (int i = 0; i < clause.size(); i++) {
+    vec<Occurrence> &occ = _occurrences[var(clause[i])];
+    int j = 0;
+    while (j < occ.size() && occ[j].partition != best)
+      j++;
+    if (j == occ.size()) {
+      Occurrence o = {best, 0};
+      occ.push(o);
+    }
+    occ[j].count++;
+  }
+
+  return best + 1;
+}
@@ -0,0 +1,85 @@
+/*!
+ * \author Vasco Manquinho - vmm@sat.inesc-id.pt
+ *
+ * @section LICENSE
+ *
+ * Open-WBO, Copyright (c) 2013-2022, Ruben Martins, Vasco Manquinho, Ines Lynce
+ * UpMax,    Copyright (c) 2022, Pedro Orvalho, Vasco Manquinho, Ruben Martins
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ */
+
+
+#ifndef __STREAM_PARTITIONER__
+#define __STREAM_PARTITIONER__
+
+#include "core/SolverTypes.h"
+#include "mtl/Vec.h"
+
+using namespace std;
+using NSPACE::Lit;
+using NSPACE::vec;
+
+namespace upmax {
+
+// One-pass greedy partitioning of clauses as they are parsed (Fennel).
+// Each clause goes to the partition where its variables occur most, minus a
+// penalty that grows with the number of clauses already in the partition.
+// Only the number of occurrences of each variable in each partition is kept.
+class Stream_Partitioner {
+public:
+  // Constructor/Destructor:
+  //
+  Stream_Partitioner(int k, double gamma = 1.5, double imbalance = 0.1);
+  ~Stream_Partitioner();
+
+  // Expected number of clauses, if known from the header
+  void setExpectedClauses(int n) { _expectedClauses = n; }
+
+  // Returns the partition of the clause, from 1 to k as in pwcnf files
+  int assign(vec<Lit> &clause);
+
+  inline int nPartitions() { return _k; }
+
+protected:
+  int _k;
+  double _gamma;
+  double _imbalance;
+
+  int _expectedClauses;
+  int _nClauses;
+  int64_t _nLiterals;
+
+  // Number of occurrences of a variable in one partition.
+  struct Occurrence {
+    int partition;
+    int count;
+  };
+
+  // Occurrences of each variable, only for the partitions where it occurs
+  // (usually one or two).
+  vec<vec<Occurrence>> _occurrences;
+  vec<int> _load;        // Number of clauses in each partition
+  vec<double> _affinity;
+};
+
+} // namespace upmax
+
+#endif
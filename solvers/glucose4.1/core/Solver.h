@@ -152,6 +152,7 @@ public:
     // Variable mode:
     // 
     void    setPolarity    (Var v, bool b); // Declare which polarity the decision heuristic should use for a variable. Requires mode 'polarity_user'.
+    void    setPhase       (Var v, bool b); // Hint the polarity of the next decision on a variable. Unlike 'setPolarity', phase saving may change it later.
     void    setDecisionVar (Var v, bool b); // Declare if a variable should be eligible for selection in the decision heuristic.
 
     // Read state:
@@ -535,6 +536,7 @@ inline int      Solver::nFreeVars     ()         {
     int a = stats[dec_vars];
     return (int)(a) - (trail_lim.size() == 0 ? trail.size() : trail_lim[0]); }
 inline void     Solver::setPolarity   (Var v, bool b) { polarity[v] = b; fixed_polarity[v] = true; }
+inline void     Solver::setPhase      (Var v, bool b) { if (!fixed_polarity[v]) polarity[v] = b; }
 inline void     Solver::setDecisionVar(Var v, bool b) 
 { 
     if      ( b && !decision[v]) stats[dec_vars]++;